@@ -0,0 +1,342 @@
+// Filter benchmark: times every stage main() used to run on reproducible synthetic
+// inputs and reports MPix/s (input pixels per second) as a table and as JSON.
+//
+//   make bench && bin/bench/bench [--sizes 256,1024,4096] [--patterns noise,gradient,checkerboard,fractal]
+//                                 [--stages Grayscale,noise,...] [--warmup N] [--runs N] [--json file]
+//
+// Sizes go up to 16384 (16K x 16K RGBA needs about 3 GB for the input and the stage buffers).
+
+#include <Filters.h>
+#include <IntegralImage.h>
+#include <RecursiveGaussian.h>
+#include <Resample.h>
+#include <Simd.h>
+#include <SyntheticImage.h>
+#include <ThreadPool.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    struct BenchOptions
+    {
+        std::vector<int> sizes = {256, 1024, 4096};
+        std::vector<SyntheticPattern> patterns = {SyntheticPattern::Noise, SyntheticPattern::Gradient,
+                                                  SyntheticPattern::Checkerboard, SyntheticPattern::Fractal};
+        std::vector<std::string> stages;    // empty means all
+        int warmup = 1;
+        int runs = 7;
+        std::string json;
+    };
+
+    struct BenchResult
+    {
+        std::string stage;
+        std::string pattern;
+        int width, height;
+        std::vector<double> milliseconds;   // sorted
+
+        double Percentile(double p) const
+        {
+            return milliseconds[std::min(milliseconds.size() - 1, (size_t)(p * milliseconds.size()))];
+        }
+        double MegapixelsPerSecond(double ms) const { return width * (double)height / 1e3 / ms; }
+    };
+
+    // Inputs of every stage, each one computed from the previous stage once up front
+    struct StageInputs
+    {
+        int width, height;
+        Image rgba;
+        std::vector<unsigned char> gray, blurred, magnitude, directions, suppressed, thresholded;
+        std::vector<unsigned char> halftone;    // 2 * width x 2 * height
+    };
+
+    // One stage: 'prepare' resets its in-place buffer (not timed), 'run' is timed
+    struct Stage
+    {
+        const char* name;
+        std::function<void(StageInputs&, std::vector<unsigned char>&)> prepare;
+        std::function<void(StageInputs&, std::vector<unsigned char>&)> run;
+    };
+
+    std::vector<int> parseSizes(const std::string& list)
+    {
+        std::vector<int> sizes;
+        std::stringstream stream(list);
+        std::string item;
+        while (std::getline(stream, item, ','))
+        {
+            const int size = std::atoi(item.c_str());
+            if (size >= 3)
+                sizes.push_back(size);
+        }
+        return sizes;
+    }
+
+    std::vector<std::string> parseList(const std::string& list)
+    {
+        std::vector<std::string> items;
+        std::stringstream stream(list);
+        std::string item;
+        while (std::getline(stream, item, ','))
+        {
+            if (!item.empty())
+                items.push_back(item);
+        }
+        return items;
+    }
+
+    const char* simdName(SimdLevel level)
+    {
+        switch (level)
+        {
+            case SimdLevel::AVX2: return "AVX2";
+            case SimdLevel::SSE2: return "SSE2";
+            default: return "scalar";
+        }
+    }
+
+    StageInputs prepareInputs(SyntheticPattern pattern, int size)
+    {
+        StageInputs in;
+        in.width = in.height = size;
+        in.rgba = makeSyntheticImage(pattern, size, size, 4, 1);
+        const int length = size * size;
+
+        // The legacy entry points take tightly packed rows, Image rows are padded
+        std::vector<unsigned char> packed((size_t)length * 4);
+        copyPixels(in.rgba.View(), ImageView(packed.data(), size, size, 4));
+        unsigned char* gray = Grayscale(packed.data(), length);
+        in.gray.assign(gray, gray + length);
+        delete[] gray;
+
+        in.blurred = in.gray;
+        noise(in.blurred.data(), size, size, length);
+        in.magnitude = in.blurred;
+        in.directions = gradientCalculation(in.magnitude.data(), size, size, length);
+        in.suppressed = in.magnitude;
+        Non_MaxSuppression(in.suppressed.data(), size, size, length, in.directions);
+        in.thresholded = in.suppressed;
+        Thresholding(in.thresholded.data(), size, size);
+
+        unsigned char* halftone = haftone(in.gray.data(), size, size);
+        in.halftone.assign(halftone, halftone + (size_t)length * 4);
+        delete[] halftone;
+        return in;
+    }
+
+    std::vector<Stage> allStages()
+    {
+        auto copyOf = [](const std::vector<unsigned char> StageInputs::*member)
+        {
+            return [member](StageInputs& in, std::vector<unsigned char>& work) { work = in.*member; };
+        };
+        auto nothing = [](StageInputs&, std::vector<unsigned char>&) {};
+
+        return {
+            {"Grayscale", [](StageInputs& in, std::vector<unsigned char>& work)
+                {
+                    work.resize((size_t)in.width * in.height * 4);
+                    copyPixels(in.rgba.View(), ImageView(work.data(), in.width, in.height, 4));
+                },
+                [](StageInputs& in, std::vector<unsigned char>& work)
+                {
+                    delete[] Grayscale(work.data(), in.width * in.height);
+                }},
+            {"noise", copyOf(&StageInputs::gray), [](StageInputs& in, std::vector<unsigned char>& work)
+                {
+                    noise(work.data(), in.width, in.height, in.width * in.height);
+                }},
+            // The Canny pre-blur for noisy inputs, the same cost at any sigma
+            {"recursiveGaussian/2", copyOf(&StageInputs::gray), [](StageInputs& in, std::vector<unsigned char>& work)
+                {
+                    ImageView image(work.data(), in.width, in.height);
+                    recursiveGaussian(image, image, 2.0f);
+                }},
+            {"recursiveGaussian/10", copyOf(&StageInputs::gray), [](StageInputs& in, std::vector<unsigned char>& work)
+                {
+                    ImageView image(work.data(), in.width, in.height);
+                    recursiveGaussian(image, image, 10.0f);
+                }},
+            {"gradientCalculation", copyOf(&StageInputs::blurred), [](StageInputs& in, std::vector<unsigned char>& work)
+                {
+                    gradientCalculation(work.data(), in.width, in.height, in.width * in.height);
+                }},
+            {"Non_MaxSuppression", copyOf(&StageInputs::magnitude), [](StageInputs& in, std::vector<unsigned char>& work)
+                {
+                    Non_MaxSuppression(work.data(), in.width, in.height, in.width * in.height, in.directions);
+                }},
+            {"Thresholding", copyOf(&StageInputs::suppressed), [](StageInputs& in, std::vector<unsigned char>& work)
+                {
+                    Thresholding(work.data(), in.width, in.height);
+                }},
+            {"Hysteresis", copyOf(&StageInputs::thresholded), [](StageInputs& in, std::vector<unsigned char>& work)
+                {
+                    Hysteresis(work.data(), in.width, in.height, in.width * in.height);
+                }},
+            // Summed-area table with squared sums, and the box mean it gives at any radius
+            {"IntegralImage", nothing, [](StageInputs& in, std::vector<unsigned char>&)
+                {
+                    IntegralImage32 table(ConstImageView(in.gray.data(), in.width, in.height), true);
+                }},
+            {"boxFilter/7", copyOf(&StageInputs::gray), [](StageInputs& in, std::vector<unsigned char>& work)
+                {
+                    ImageView image(work.data(), in.width, in.height);
+                    boxFilter(image, image, 7);
+                }},
+            {"haftone", nothing, [](StageInputs& in, std::vector<unsigned char>&)
+                {
+                    delete[] haftone(in.gray.data(), in.width, in.height);
+                }},
+            // compressImage() is fixed at 512 -> 256, this is the same 2x box reduction at any size
+            {"compressImage", [](StageInputs& in, std::vector<unsigned char>& work)
+                {
+                    work.resize((size_t)in.width * in.height);
+                },
+                [](StageInputs& in, std::vector<unsigned char>& work)
+                {
+                    areaResample(in.halftone.data(), 2 * in.width, 2 * in.height, 0, work.data(), in.width, in.height, 0);
+                }},
+            {"floydSteinbergTo16Grayscale", nothing, [](StageInputs& in, std::vector<unsigned char>&)
+                {
+                    delete[] floydSteinbergTo16Grayscale(in.gray.data(), in.width, in.height);
+                }},
+        };
+    }
+
+    void printTable(const std::vector<BenchResult>& results, std::ostream& out)
+    {
+        out << std::left << std::setw(30) << "stage" << std::setw(14) << "pattern" << std::setw(13) << "size"
+            << std::right << std::setw(11) << "median ms" << std::setw(14) << "median MPix/s"
+            << std::setw(11) << "p10 MPix/s" << std::setw(11) << "p90 MPix/s" << std::endl;
+        out << std::fixed;
+        for (const BenchResult& r : results)
+        {
+            const std::string size = std::to_string(r.width) + "x" + std::to_string(r.height);
+            // The slow end of the runs is the low throughput percentile
+            out << std::left << std::setw(30) << r.stage << std::setw(14) << r.pattern << std::setw(13) << size
+                << std::right << std::setprecision(3) << std::setw(11) << r.Percentile(0.5)
+                << std::setprecision(1) << std::setw(14) << r.MegapixelsPerSecond(r.Percentile(0.5))
+                << std::setw(11) << r.MegapixelsPerSecond(r.Percentile(0.9))
+                << std::setw(11) << r.MegapixelsPerSecond(r.Percentile(0.1)) << std::endl;
+        }
+    }
+
+    bool writeJson(const std::vector<BenchResult>& results, const BenchOptions& options, const std::string& path)
+    {
+        std::ofstream out(path);
+        out << std::fixed << std::setprecision(4);
+        out << "{\n  \"threads\": " << ThreadPool::Global().GetThreadCount() << ",\n  \"simd\": \""
+            << simdName(detectSimdLevel()) << "\",\n  \"warmup\": " << options.warmup
+            << ",\n  \"runs\": " << options.runs << ",\n  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            const BenchResult& r = results[i];
+            out << "    {\"stage\": \"" << r.stage << "\", \"pattern\": \"" << r.pattern << "\", \"width\": " << r.width
+                << ", \"height\": " << r.height << ", \"median_ms\": " << r.Percentile(0.5)
+                << ", \"median_mpix_s\": " << r.MegapixelsPerSecond(r.Percentile(0.5))
+                << ", \"p10_mpix_s\": " << r.MegapixelsPerSecond(r.Percentile(0.9))
+                << ", \"p90_mpix_s\": " << r.MegapixelsPerSecond(r.Percentile(0.1))
+                << ", \"ms\": [";
+            for (size_t k = 0; k < r.milliseconds.size(); k++)
+                out << (k ? ", " : "") << r.milliseconds[k];
+            out << "]}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+        return (bool)out;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    BenchOptions options;
+    for (int i = 1; i < argc; i++)
+    {
+        const bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--sizes") == 0 && has_value)
+            options.sizes = parseSizes(argv[++i]);
+        else if (strcmp(argv[i], "--patterns") == 0 && has_value)
+        {
+            options.patterns.clear();
+            for (const std::string& name : parseList(argv[++i]))
+            {
+                SyntheticPattern pattern;
+                if (!parseSyntheticPattern(name, pattern))
+                {
+                    std::cerr << "Unknown pattern " << name << std::endl;
+                    return 1;
+                }
+                options.patterns.push_back(pattern);
+            }
+        }
+        else if (strcmp(argv[i], "--stages") == 0 && has_value)
+            options.stages = parseList(argv[++i]);
+        else if (strcmp(argv[i], "--warmup") == 0 && has_value)
+            options.warmup = std::max(0, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--runs") == 0 && has_value)
+            options.runs = std::max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--json") == 0 && has_value)
+            options.json = argv[++i];
+        else
+        {
+            std::cerr << "Unknown option " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << ThreadPool::Global().GetThreadCount() << " threads, " << simdName(detectSimdLevel())
+              << ", " << options.warmup << " warmup + " << options.runs << " runs per stage" << std::endl;
+
+    std::vector<Stage> stages;
+    for (const Stage& stage : allStages())
+    {
+        if (options.stages.empty() || std::find(options.stages.begin(), options.stages.end(), stage.name) != options.stages.end())
+            stages.push_back(stage);
+    }
+
+    std::vector<BenchResult> results;
+    for (int size : options.sizes)
+    {
+        for (SyntheticPattern pattern : options.patterns)
+        {
+            StageInputs inputs = prepareInputs(pattern, size);
+            std::vector<unsigned char> work;
+            for (const Stage& stage : stages)
+            {
+                BenchResult result{stage.name, syntheticPatternName(pattern), size, size, {}};
+                for (int run = 0; run < options.warmup + options.runs; run++)
+                {
+                    stage.prepare(inputs, work);
+                    const Clock::time_point start = Clock::now();
+                    stage.run(inputs, work);
+                    const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+                    if (run >= options.warmup)
+                        result.milliseconds.push_back(ms);
+                }
+                std::sort(result.milliseconds.begin(), result.milliseconds.end());
+                results.push_back(result);
+            }
+        }
+    }
+
+    printTable(results, std::cout);
+    if (!options.json.empty() && !writeJson(results, options, options.json))
+    {
+        std::cerr << "Failed to write " << options.json << std::endl;
+        return 1;
+    }
+    return 0;
+}
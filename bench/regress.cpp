@@ -0,0 +1,979 @@
+// Regression harness: every variant of a stage (scalar, SIMD, tiled, streamed, fused,
+// the pipeline) runs on a fixed synthetic corpus and is compared with the golden images
+// in bench/golden, exactly or within the tolerance it declares. Each variant is then
+// timed on a larger frame and checked against a stored throughput baseline.
+//
+//   make regress && bin/bench/regress [--golden dir] [--update-golden] [--no-perf] [--perf-size N] [--runs N]
+//                                     [--baseline file] [--save-baseline file] [--max-slowdown percent]
+//
+// --update-golden rewrites the golden images from the scalar reference of each output.
+// Baselines are per machine, so none is committed: save one on a known good build and
+// pass it to later runs.
+
+#include <stb/stb_image.h>
+
+#include <CannyEngine.h>
+#include <ColorConvert.h>
+#include <Dither.h>
+#include <Filters.h>
+#include <GaussianBlur.h>
+#include <Halftone.h>
+#include <HysteresisEngine.h>
+#include <ImagePipeline.h>
+#include <IntegralImage.h>
+#include <ParallelFilters.h>
+#include <PngWriter.h>
+#include <PnmStream.h>
+#include <RecursiveGaussian.h>
+#include <Resample.h>
+#include <Simd.h>
+#include <Sobel.h>
+#include <SyntheticImage.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    struct RegressOptions
+    {
+        std::string goldenDirectory = "bench/golden/";
+        bool updateGolden = false;
+        bool perf = true;
+        int perfSize = 1024;
+        int runs = 5;
+        std::string baseline;
+        std::string saveBaseline;
+        double maxSlowdown = 10.0;      // percent
+    };
+
+    struct CorpusImage
+    {
+        SyntheticPattern pattern;
+        int width, height;
+    };
+
+    // Odd sizes on purpose: SIMD tails, partial tiles and short last strips all get hit
+    const CorpusImage kCorpus[] = {
+        {SyntheticPattern::Fractal, 256, 256},
+        {SyntheticPattern::Noise, 131, 97},
+        {SyntheticPattern::Gradient, 200, 120},
+        {SyntheticPattern::Checkerboard, 97, 131},
+    };
+
+    // Largest allowed |difference| and the share of pixels that may differ at all
+    struct Tolerance
+    {
+        int maxDifference;
+        double maxFraction;
+    };
+    const Tolerance kExact = {0, 0.0};
+
+    // What every variant gets: the RGBA source and the reference grayscale of it, so a
+    // broken stage doesn't fail everything downstream
+    struct Inputs
+    {
+        const Image& rgba;
+        const Image& gray;
+        TileExecutor& executor;
+        ThreadPool& wavefrontPool;
+    };
+
+    // One implementation of one output. An empty image means "not applicable here".
+    struct Variant
+    {
+        const char* output;
+        const char* name;
+        Tolerance tolerance;
+        std::function<Image(const Inputs&)> run;
+    };
+
+    std::vector<unsigned char> packed(ConstImageView view)
+    {
+        std::vector<unsigned char> pixels((size_t)view.GetWidth() * view.GetHeight() * view.GetChannels());
+        copyPixels(view, ImageView(pixels.data(), view.GetWidth(), view.GetHeight(), view.GetChannels()));
+        return pixels;
+    }
+
+    Image imageOf(const unsigned char* pixels, int width, int height)
+    {
+        Image image(width, height, 1);
+        copyPixels(ConstImageView(pixels, width, height), image.View());
+        return image;
+    }
+
+    // ---- Scalar references, these write the golden images ----
+
+    Image referenceGrayscale(const Image& rgba, SimdLevel level = SimdLevel::Scalar)
+    {
+        Image out(rgba.GetWidth(), rgba.GetHeight(), 1);
+        for (int y = 0; y < rgba.GetHeight(); y++)
+            lumaRow(rgba.GetRow(y), PixelFormat::RGBA, out.GetRow(y), rgba.GetWidth(), level);
+        return out;
+    }
+
+    // noise() -> gradientCalculation() -> Non_MaxSuppression() with the row kernels forced to 'level'
+    Image referenceSuppressed(const Image& gray, SimdLevel level)
+    {
+        const int width = gray.GetWidth(), height = gray.GetHeight();
+        Image blurred = gray.Clone();
+        for (int y = 1; y < height - 1; y++)
+            gaussianRow3x3(gray.GetRow(y - 1), gray.GetRow(y), gray.GetRow(y + 1), blurred.GetRow(y), width, level);
+
+        // The row kernels leave the frame border alone, Non_MaxSuppression() reads it as 0
+        Image magnitude = Image::Zeroed(width, height, 1), directions = Image::Zeroed(width, height, 1);
+        for (int y = 1; y < height - 1; y++)
+        {
+            sobelRow(blurred.GetRow(y - 1), blurred.GetRow(y), blurred.GetRow(y + 1),
+                     magnitude.GetRow(y), directions.GetRow(y), width, GradientNorm::L2, level);
+        }
+
+        Image suppressed(width, height, 1);
+        Non_MaxSuppression(magnitude.View(), directions.View(), suppressed.View());
+        return suppressed;
+    }
+
+    Image referenceCanny(const Image& gray, SimdLevel level = SimdLevel::Scalar)
+    {
+        Image edges = referenceSuppressed(gray, level);
+        Thresholding(edges.View());
+        Image out(gray.GetWidth(), gray.GetHeight(), 1);
+        Hysteresis(edges.View(), out.View());
+        return out;
+    }
+
+    // Thresholds with a real weak band, so connected hysteresis has chains to follow
+    CannyParams weakParams()
+    {
+        CannyParams params;
+        params.low = 6;
+        params.high = 16;
+        params.hysteresis = HysteresisMode::Connected;
+        return params;
+    }
+
+    Image referenceWeakEdges(const Image& gray)
+    {
+        const CannyParams params = weakParams();
+        Image edges = referenceSuppressed(gray, SimdLevel::Scalar);
+        for (int y = 0; y < edges.GetHeight(); y++)
+        {
+            unsigned char* row = edges.GetRow(y);
+            for (int x = 0; x < edges.GetWidth(); x++)
+                row[x] = row[x] > params.high ? 255 : row[x] > params.low ? 1 : 0;
+        }
+        return edges;
+    }
+
+    Image referenceCannyWeak(const Image& gray)
+    {
+        std::vector<unsigned char> edges = packed(referenceWeakEdges(gray).View());
+        hysteresisTrace(edges.data(), edges.data(), gray.GetWidth(), gray.GetHeight());
+        return imageOf(edges.data(), gray.GetWidth(), gray.GetHeight());
+    }
+
+    // Recursive pre-blur: a sigma the 3x3 kernel can't do, thresholds low enough for what's left of the gradients
+    const float kBlurSigma = 3.0f;
+
+    CannyParams blurredParams()
+    {
+        CannyParams params = weakParams();
+        params.blur = CannyBlur::Recursive;
+        params.sigma = kBlurSigma;
+        return params;
+    }
+
+    Image referenceBlur(const Image& gray, ThreadPool& pool, SimdLevel level = SimdLevel::Scalar)
+    {
+        Image out(gray.GetWidth(), gray.GetHeight(), 1);
+        RecursiveGaussian(kBlurSigma).Apply(gray.View(), out.View(), pool, level);
+        return out;
+    }
+
+    // referenceBlur() in place of noise(), then the Filters stages and hysteresisTrace()
+    Image referenceCannyBlurred(const Image& gray, ThreadPool& pool)
+    {
+        const int width = gray.GetWidth(), height = gray.GetHeight();
+        const CannyParams params = blurredParams();
+        Image blurred = referenceBlur(gray, pool);
+        Image magnitude(width, height, 1), directions(width, height, 1), edges(width, height, 1);
+        gradientCalculation(blurred.View(), magnitude.View(), directions.View());
+        Non_MaxSuppression(magnitude.View(), directions.View(), edges.View());
+
+        std::vector<unsigned char> thresholded = packed(edges.View());
+        for (unsigned char& pixel : thresholded)
+            pixel = pixel > params.high ? 255 : pixel > params.low ? 1 : 0;
+        hysteresisTrace(thresholded.data(), thresholded.data(), width, height);
+        return imageOf(thresholded.data(), width, height);
+    }
+
+    // Box means and local contrast (standard deviation) over clipped square windows
+    const int kBoxRadius = 3;
+    const int kContrastRadius = 4;
+
+    inline unsigned char contrastPixel(double variance)
+    {
+        return (unsigned char)std::min(255.0, std::sqrt(variance) + 0.5);
+    }
+
+    // Every window summed pixel by pixel, rounded like boxFilter() and IntegralImage::Variance()
+    Image referenceWindows(const Image& gray, int radius, bool contrast)
+    {
+        const int width = gray.GetWidth(), height = gray.GetHeight();
+        Image out(width, height, 1);
+        for (int y = 0; y < height; y++)
+        {
+            const int top = std::max(0, y - radius), bottom = std::min(height, y + radius + 1);
+            for (int x = 0; x < width; x++)
+            {
+                const int left = std::max(0, x - radius), right = std::min(width, x + radius + 1);
+                unsigned long long sum = 0, squares = 0;
+                for (int wy = top; wy < bottom; wy++)
+                {
+                    for (int wx = left; wx < right; wx++)
+                    {
+                        const unsigned int pixel = gray.GetRow(wy)[wx];
+                        sum += pixel;
+                        squares += pixel * pixel;
+                    }
+                }
+                const unsigned long long count = (unsigned long long)(right - left) * (bottom - top);
+                const double mean = (double)sum / count;
+                out.GetRow(y)[x] = contrast ? contrastPixel(std::max(0.0, (double)squares / count - mean * mean))
+                                            : (unsigned char)((sum + count / 2) / count);
+            }
+        }
+        return out;
+    }
+
+    template <typename T>
+    Image windowsFromTable(const BasicIntegralImage<T>& table, int radius, bool contrast)
+    {
+        const int width = table.GetWidth(), height = table.GetHeight();
+        Image out(width, height, 1);
+        for (int y = 0; y < height; y++)
+        {
+            const int top = std::max(0, y - radius), bottom = std::min(height, y + radius + 1);
+            for (int x = 0; x < width; x++)
+            {
+                const int left = std::max(0, x - radius), right = std::min(width, x + radius + 1);
+                const T count = (T)(right - left) * (T)(bottom - top);
+                out.GetRow(y)[x] = contrast ? contrastPixel(table.Variance(left, top, right - left, bottom - top))
+                                            : (unsigned char)((table.Sum(left, top, right - left, bottom - top) + count / 2) / count);
+            }
+        }
+        return out;
+    }
+
+    Image referenceHalftone2x(const Image& gray)
+    {
+        std::vector<unsigned char> source = packed(gray.View());
+        unsigned char* pattern = haftone(source.data(), gray.GetWidth(), gray.GetHeight());
+        Image out = imageOf(pattern, 2 * gray.GetWidth(), 2 * gray.GetHeight());
+        delete[] pattern;
+        return out;
+    }
+
+    // haftone() then compressImage()'s 2x2 sum / 4, at any size
+    Image referenceHalftone(const Image& gray)
+    {
+        Image pattern = referenceHalftone2x(gray);
+        Image out(gray.GetWidth(), gray.GetHeight(), 1);
+        for (int y = 0; y < out.GetHeight(); y++)
+        {
+            const unsigned char* top = pattern.GetRow(2 * y);
+            const unsigned char* bottom = pattern.GetRow(2 * y + 1);
+            for (int x = 0; x < out.GetWidth(); x++)
+                out.GetRow(y)[x] = (unsigned char)((top[2 * x] + top[2 * x + 1] + bottom[2 * x] + bottom[2 * x + 1]) / 4);
+        }
+        return out;
+    }
+
+    Image referenceDither(const Image& gray)
+    {
+        Image out(gray.GetWidth(), gray.GetHeight(), 1);
+        ErrorDiffuser<FloydSteinbergKernel, 16> diffuser(gray.GetWidth());
+        diffuser.Process(gray.GetData(), gray.GetHeight(), gray.GetStride(), out.GetData(), out.GetStride());
+        return out;
+    }
+
+    // ---- Variants ----
+
+    PipelineResult runPipeline(const Inputs& in)
+    {
+        PipelineOptions options;
+        options.writeOutputs = false;
+        options.logStages = false;
+        ImagePipeline pipeline(in.executor, options);
+        return pipeline.Run(in.rgba);
+    }
+
+    Image pngRoundTrip(const Image& gray, const PngOptions& options)
+    {
+        std::vector<unsigned char> encoded;
+        if (!encodePng(gray.View(), encoded, options))
+            return Image(1, 1, 1);  // mismatches the golden size, reported as a failure
+        int width, height, comps;
+        unsigned char* decoded = stbi_load_from_memory(encoded.data(), (int)encoded.size(), &width, &height, &comps, 1);
+        if (!decoded)
+            return Image(1, 1, 1);
+        Image out = imageOf(decoded, width, height);
+        stbi_image_free(decoded);
+        return out;
+    }
+
+    // A 4 bit grey (maxval 15) scan: 'gray' quantised to 0..15, and what a reader should
+    // make of it, each level times 255 / 15
+    const int kPnmMaxval = 15;
+
+    inline unsigned char quantisedSample(unsigned char pixel)
+    {
+        return (unsigned char)((pixel * kPnmMaxval + 127) / 255);
+    }
+
+    Image referencePnmMaxval(const Image& gray)
+    {
+        Image out(gray.GetWidth(), gray.GetHeight(), 1);
+        for (int y = 0; y < gray.GetHeight(); y++)
+        {
+            for (int x = 0; x < gray.GetWidth(); x++)
+                out.GetRow(y)[x] = (unsigned char)(quantisedSample(gray.GetRow(y)[x]) * (255 / kPnmMaxval));
+        }
+        return out;
+    }
+
+    // Writes the quantised scan as a P5 file and streams it back through PnmReader
+    Image pnmMaxvalRoundTrip(const Image& gray)
+    {
+        const int width = gray.GetWidth(), height = gray.GetHeight();
+        const std::string path = (std::filesystem::temp_directory_path() / "regress_maxval.pgm").string();
+        {
+            std::ofstream file(path, std::ios::binary);
+            file << "P5\n" << width << " " << height << "\n" << kPnmMaxval << "\n";
+            std::vector<unsigned char> samples = packed(gray.View());
+            for (unsigned char& sample : samples)
+                sample = quantisedSample(sample);
+            file.write((const char*)samples.data(), (std::streamsize)samples.size());
+        }
+
+        Image out(width, height, 1);
+        PnmReader reader;
+        bool ok = reader.Open(path) && reader.GetWidth() == width && reader.GetHeight() == height;
+        for (int y = 0; ok && y < height; y += 7)
+            ok = reader.ReadRows(out.GetRow(y), std::min(7, height - y), out.GetStride());
+        std::remove(path.c_str());
+        return ok ? std::move(out) : Image(1, 1, 1);
+    }
+
+    Variant simdVariant(const char* output, const char* name, SimdLevel level,
+                        const std::function<Image(const Inputs&, SimdLevel)>& run)
+    {
+        return {output, name, kExact, [level, run](const Inputs& in)
+        {
+            return supportedSimdLevel(level) == level ? run(in, level) : Image();
+        }};
+    }
+
+    template <typename T>
+    Variant tableVariant(const char* output, const char* name, SimdLevel level, bool singleThread)
+    {
+        const bool contrast = std::strcmp(output, "contrast_r4") == 0;
+        return simdVariant(output, name, level, [contrast, singleThread](const Inputs& in, SimdLevel forced)
+        {
+            ThreadPool single(1);
+            BasicIntegralImage<T> table;
+            table.Build(in.gray.View(), contrast, singleThread ? single : in.executor.GetPool(), forced);
+            return windowsFromTable(table, contrast ? kContrastRadius : kBoxRadius, contrast);
+        });
+    }
+
+    Variant pngVariant(int level, int stripRows, const char* name)
+    {
+        return {"grayscale", name, kExact, [level, stripRows](const Inputs& in)
+        {
+            PngOptions options;
+            options.level = level;
+            options.stripRows = stripRows;
+            return pngRoundTrip(in.gray, options);
+        }};
+    }
+
+    std::vector<Variant> allVariants()
+    {
+        std::vector<Variant> variants;
+
+        // Grayscale
+        variants.push_back({"grayscale", "reference (lumaRow scalar)", kExact, [](const Inputs& in)
+        {
+            return referenceGrayscale(in.rgba);
+        }});
+        variants.push_back(simdVariant("grayscale", "lumaRow SSE2", SimdLevel::SSE2, [](const Inputs& in, SimdLevel level)
+        {
+            return referenceGrayscale(in.rgba, level);
+        }));
+        variants.push_back(simdVariant("grayscale", "lumaRow AVX2", SimdLevel::AVX2, [](const Inputs& in, SimdLevel level)
+        {
+            return referenceGrayscale(in.rgba, level);
+        }));
+        variants.push_back({"grayscale", "lumaImage", kExact, [](const Inputs& in)
+        {
+            Image out(in.rgba.GetWidth(), in.rgba.GetHeight(), 1);
+            lumaImage(in.rgba.GetData(), in.rgba.GetStride(), PixelFormat::RGBA, out.GetData(), out.GetStride(),
+                      in.rgba.GetWidth(), in.rgba.GetHeight(), in.executor.GetPool());
+            return out;
+        }});
+        variants.push_back({"grayscale", "Grayscale", kExact, [](const Inputs& in)
+        {
+            std::vector<unsigned char> rgba = packed(in.rgba.View());
+            unsigned char* gray = Grayscale(rgba.data(), in.rgba.GetWidth() * in.rgba.GetHeight());
+            Image out = imageOf(gray, in.rgba.GetWidth(), in.rgba.GetHeight());
+            delete[] gray;
+            return out;
+        }});
+        variants.push_back({"grayscale", "GrayscaleTiled", kExact, [](const Inputs& in)
+        {
+            std::vector<unsigned char> rgba = packed(in.rgba.View());
+            unsigned char* gray = GrayscaleTiled(rgba.data(), in.rgba.GetWidth() * in.rgba.GetHeight(), in.executor);
+            Image out = imageOf(gray, in.rgba.GetWidth(), in.rgba.GetHeight());
+            delete[] gray;
+            return out;
+        }});
+        variants.push_back({"grayscale", "ImagePipeline", kExact, [](const Inputs& in)
+        {
+            return std::move(runPipeline(in).grayscale);
+        }});
+        // PNG is lossless: what stb_image decodes must be the pixels that went in
+        variants.push_back(pngVariant(0, 0, "PNG level 0 round trip"));
+        variants.push_back(pngVariant(1, 0, "PNG level 1 round trip"));
+        variants.push_back(pngVariant(3, 0, "PNG level 3 round trip"));
+        variants.push_back(pngVariant(6, 0, "PNG level 6 round trip"));
+        variants.push_back(pngVariant(9, 64, "PNG level 9, 64 row strips, round trip"));
+
+        // PNM inputs with a maxval below 255 come out scaled to 0..255
+        variants.push_back({"pnm_maxval", "reference (levels times 17)", kExact, [](const Inputs& in)
+        {
+            return referencePnmMaxval(in.gray);
+        }});
+        variants.push_back({"pnm_maxval", "PnmReader, 7 row strips", kExact, [](const Inputs& in)
+        {
+            return pnmMaxvalRoundTrip(in.gray);
+        }});
+
+        // Canny (the defaults: no weak band, so every hysteresis mode agrees)
+        variants.push_back({"canny", "reference (scalar rows, Filters stages)", kExact, [](const Inputs& in)
+        {
+            return referenceCanny(in.gray);
+        }});
+        variants.push_back(simdVariant("canny", "gaussianRow3x3 / sobelRow SSE2", SimdLevel::SSE2, [](const Inputs& in, SimdLevel level)
+        {
+            return referenceCanny(in.gray, level);
+        }));
+        variants.push_back(simdVariant("canny", "gaussianRow3x3 / sobelRow AVX2", SimdLevel::AVX2, [](const Inputs& in, SimdLevel level)
+        {
+            return referenceCanny(in.gray, level);
+        }));
+        variants.push_back({"canny", "Filters full frame", kExact, [](const Inputs& in)
+        {
+            const int width = in.gray.GetWidth(), height = in.gray.GetHeight(), length = width * height;
+            std::vector<unsigned char> image = packed(in.gray.View());
+            noise(image.data(), width, height, length);
+            std::vector<unsigned char> directions = gradientCalculation(image.data(), width, height, length);
+            Non_MaxSuppression(image.data(), width, height, length, directions);
+            Thresholding(image.data(), width, height);
+            Hysteresis(image.data(), width, height, length);
+            return imageOf(image.data(), width, height);
+        }});
+        variants.push_back({"canny", "Filters tiled", kExact, [](const Inputs& in)
+        {
+            const int width = in.gray.GetWidth(), height = in.gray.GetHeight();
+            std::vector<unsigned char> image = packed(in.gray.View());
+            noiseTiled(image.data(), width, height, in.executor);
+            std::vector<unsigned char> directions = gradientCalculationTiled(image.data(), width, height, in.executor);
+            Non_MaxSuppressionTiled(image.data(), width, height, directions, in.executor);
+            ThresholdingTiled(image.data(), width, height, in.executor);
+            HysteresisTiled(image.data(), width, height, in.executor);
+            return imageOf(image.data(), width, height);
+        }});
+        variants.push_back({"canny", "cannyTiled", kExact, [](const Inputs& in)
+        {
+            Image out(in.gray.GetWidth(), in.gray.GetHeight(), 1);
+            cannyTiled(in.gray.View(), out.View(), in.executor);
+            return out;
+        }});
+        variants.push_back({"canny", "CannyEngine", kExact, [](const Inputs& in)
+        {
+            const int width = in.gray.GetWidth(), height = in.gray.GetHeight();
+            std::vector<unsigned char> image = packed(in.gray.View());
+            CannyEngine engine(width);
+            engine.Process(image.data(), image.data(), height);
+            return imageOf(image.data(), width, height);
+        }});
+        variants.push_back({"canny", "CannyEngine row by row", kExact, [](const Inputs& in)
+        {
+            CannyParams params;
+            params.hysteresis = HysteresisMode::Neighbours;
+            Image out(in.gray.GetWidth(), in.gray.GetHeight(), 1);
+            CannyEngine::RowSink sink = [&](const unsigned char* row, int y)
+            {
+                std::memcpy(out.GetRow(y), row, out.GetWidth());
+            };
+            CannyEngine engine(in.gray.GetWidth(), params);
+            engine.Begin(in.gray.GetHeight());
+            for (int y = 0; y < in.gray.GetHeight(); y++)
+                engine.PushRow(in.gray.GetRow(y), sink);
+            engine.Finish(sink);
+            return out;
+        }});
+        variants.push_back({"canny", "ImagePipeline", kExact, [](const Inputs& in)
+        {
+            return std::move(runPipeline(in).canny);
+        }});
+
+        // Canny with weak edges and connected hysteresis
+        variants.push_back({"canny_weak", "reference (hysteresisTrace)", kExact, [](const Inputs& in)
+        {
+            return referenceCannyWeak(in.gray);
+        }});
+        variants.push_back({"canny_weak", "hysteresisUnionFind", kExact, [](const Inputs& in)
+        {
+            Image edges = referenceWeakEdges(in.gray);
+            hysteresisUnionFind(edges.GetData(), edges.GetData(), edges.GetWidth(), edges.GetHeight(),
+                                in.executor, edges.GetStride());
+            return edges;
+        }});
+        variants.push_back({"canny_weak", "cannyTiled", kExact, [](const Inputs& in)
+        {
+            Image out(in.gray.GetWidth(), in.gray.GetHeight(), 1);
+            cannyTiled(in.gray.View(), out.View(), in.executor, weakParams());
+            return out;
+        }});
+        variants.push_back({"canny_weak", "CannyEngine", kExact, [](const Inputs& in)
+        {
+            const int width = in.gray.GetWidth(), height = in.gray.GetHeight();
+            std::vector<unsigned char> image = packed(in.gray.View());
+            CannyEngine engine(width, weakParams());
+            engine.Process(image.data(), image.data(), height);
+            return imageOf(image.data(), width, height);
+        }});
+
+        // Recursive Gaussian, every level and thread count rounds alike
+        variants.push_back({"blur_sigma3", "reference (RecursiveGaussian scalar)", kExact, [](const Inputs& in)
+        {
+            return referenceBlur(in.gray, in.executor.GetPool());
+        }});
+        variants.push_back(simdVariant("blur_sigma3", "RecursiveGaussian SSE2", SimdLevel::SSE2, [](const Inputs& in, SimdLevel level)
+        {
+            return referenceBlur(in.gray, in.executor.GetPool(), level);
+        }));
+        variants.push_back(simdVariant("blur_sigma3", "RecursiveGaussian AVX2", SimdLevel::AVX2, [](const Inputs& in, SimdLevel level)
+        {
+            return referenceBlur(in.gray, in.executor.GetPool(), level);
+        }));
+        variants.push_back({"blur_sigma3", "recursiveGaussian in place, 1 thread", kExact, [](const Inputs& in)
+        {
+            ThreadPool single(1);
+            Image out = in.gray.Clone();
+            recursiveGaussian(out.View(), out.View(), kBlurSigma, single);
+            return out;
+        }});
+
+        // Canny with the recursive pre-blur
+        variants.push_back({"canny_sigma3", "reference (RecursiveGaussian, Filters stages)", kExact, [](const Inputs& in)
+        {
+            return referenceCannyBlurred(in.gray, in.executor.GetPool());
+        }});
+        variants.push_back({"canny_sigma3", "cannyTiled", kExact, [](const Inputs& in)
+        {
+            Image out(in.gray.GetWidth(), in.gray.GetHeight(), 1);
+            cannyTiled(in.gray.View(), out.View(), in.executor, blurredParams());
+            return out;
+        }});
+        variants.push_back({"canny_sigma3", "CannyEngine", kExact, [](const Inputs& in)
+        {
+            const int width = in.gray.GetWidth(), height = in.gray.GetHeight();
+            std::vector<unsigned char> image = packed(in.gray.View());
+            CannyEngine engine(width, blurredParams());
+            engine.Process(image.data(), image.data(), height);
+            return imageOf(image.data(), width, height);
+        }});
+
+        // Box means and local contrast from summed-area tables
+        variants.push_back({"box_r3", "reference (window loops)", kExact, [](const Inputs& in)
+        {
+            return referenceWindows(in.gray, kBoxRadius, false);
+        }});
+        variants.push_back(tableVariant<unsigned int>("box_r3", "IntegralImage32 scalar", SimdLevel::Scalar, false));
+        variants.push_back(tableVariant<unsigned int>("box_r3", "IntegralImage32 SSE2", SimdLevel::SSE2, false));
+        variants.push_back(tableVariant<unsigned int>("box_r3", "IntegralImage32 AVX2", SimdLevel::AVX2, false));
+        variants.push_back(tableVariant<unsigned long long>("box_r3", "IntegralImage64 AVX2, 1 thread", SimdLevel::AVX2, true));
+        variants.push_back({"box_r3", "boxFilter in place", kExact, [](const Inputs& in)
+        {
+            Image out = in.gray.Clone();
+            boxFilter(out.View(), out.View(), kBoxRadius, in.executor.GetPool());
+            return out;
+        }});
+        variants.push_back({"contrast_r4", "reference (window loops)", kExact, [](const Inputs& in)
+        {
+            return referenceWindows(in.gray, kContrastRadius, true);
+        }});
+        variants.push_back(tableVariant<unsigned int>("contrast_r4", "IntegralImage32 scalar", SimdLevel::Scalar, false));
+        variants.push_back(tableVariant<unsigned int>("contrast_r4", "IntegralImage32 SSE2", SimdLevel::SSE2, false));
+        variants.push_back(tableVariant<unsigned int>("contrast_r4", "IntegralImage32 AVX2", SimdLevel::AVX2, false));
+        variants.push_back(tableVariant<unsigned long long>("contrast_r4", "IntegralImage64 SSE2", SimdLevel::SSE2, false));
+        variants.push_back(tableVariant<unsigned long long>("contrast_r4", "IntegralImage64 AVX2, 1 thread", SimdLevel::AVX2, true));
+
+        // Halftone at the input size
+        variants.push_back({"halftone", "reference (haftone + 2x2 mean)", kExact, [](const Inputs& in)
+        {
+            return referenceHalftone(in.gray);
+        }});
+        variants.push_back({"halftone", "fusedHalftone", kExact, [](const Inputs& in)
+        {
+            Image out(in.gray.GetWidth(), in.gray.GetHeight(), 1);
+            fusedHalftone(in.gray.GetData(), in.gray.GetWidth(), in.gray.GetHeight(), in.gray.GetStride(),
+                          out.GetData(), out.GetWidth(), out.GetHeight(), out.GetStride(), in.executor.GetPool());
+            return out;
+        }});
+        variants.push_back({"halftone", "haftoneTiled + areaResample", kExact, [](const Inputs& in)
+        {
+            const int width = in.gray.GetWidth(), height = in.gray.GetHeight();
+            std::vector<unsigned char> source = packed(in.gray.View());
+            unsigned char* pattern = haftoneTiled(source.data(), width, height, in.executor);
+            Image out(width, height, 1);
+            areaResample(pattern, 2 * width, 2 * height, 0, out.GetData(), width, height, out.GetStride(), 1,
+                         in.executor.GetPool());
+            delete[] pattern;
+            return out;
+        }});
+        variants.push_back({"halftone", "haftone + compressImage", kExact, [](const Inputs& in)
+        {
+            // compressImage() only knows 512 -> 256
+            if (in.gray.GetWidth() != 256 || in.gray.GetHeight() != 256)
+                return Image();
+            std::vector<unsigned char> source = packed(in.gray.View());
+            unsigned char* pattern = haftone(source.data(), 256, 256);
+            std::vector<unsigned char> out(256 * 256);
+            compressImage(pattern, out.data());
+            delete[] pattern;
+            return imageOf(out.data(), 256, 256);
+        }});
+        variants.push_back({"halftone", "haftoneTiled + compressImageTiled", kExact, [](const Inputs& in)
+        {
+            if (in.gray.GetWidth() != 256 || in.gray.GetHeight() != 256)
+                return Image();
+            std::vector<unsigned char> source = packed(in.gray.View());
+            unsigned char* pattern = haftoneTiled(source.data(), 256, 256, in.executor);
+            std::vector<unsigned char> out(256 * 256);
+            compressImageTiled(pattern, out.data(), in.executor);
+            delete[] pattern;
+            return imageOf(out.data(), 256, 256);
+        }});
+        variants.push_back({"halftone", "ImagePipeline", kExact, [](const Inputs& in)
+        {
+            return std::move(runPipeline(in).halftone);
+        }});
+
+        // The raw 2x2 patterns
+        variants.push_back({"halftone2x", "reference (haftone)", kExact, [](const Inputs& in)
+        {
+            return referenceHalftone2x(in.gray);
+        }});
+        variants.push_back({"halftone2x", "fusedHalftone", kExact, [](const Inputs& in)
+        {
+            Image out(2 * in.gray.GetWidth(), 2 * in.gray.GetHeight(), 1);
+            fusedHalftone(in.gray.GetData(), in.gray.GetWidth(), in.gray.GetHeight(), in.gray.GetStride(),
+                          out.GetData(), out.GetWidth(), out.GetHeight(), out.GetStride(), in.executor.GetPool());
+            return out;
+        }});
+        variants.push_back({"halftone2x", "haftoneTiled", kExact, [](const Inputs& in)
+        {
+            std::vector<unsigned char> source = packed(in.gray.View());
+            unsigned char* pattern = haftoneTiled(source.data(), in.gray.GetWidth(), in.gray.GetHeight(), in.executor);
+            Image out = imageOf(pattern, 2 * in.gray.GetWidth(), 2 * in.gray.GetHeight());
+            delete[] pattern;
+            return out;
+        }});
+
+        // Floyd-Steinberg to 16 levels
+        variants.push_back({"dither", "reference (ErrorDiffuser, serial)", kExact, [](const Inputs& in)
+        {
+            return referenceDither(in.gray);
+        }});
+        variants.push_back({"dither", "floydSteinbergTo16Grayscale", kExact, [](const Inputs& in)
+        {
+            std::vector<unsigned char> source = packed(in.gray.View());
+            unsigned char* dithered = floydSteinbergTo16Grayscale(source.data(), in.gray.GetWidth(), in.gray.GetHeight());
+            Image out = imageOf(dithered, in.gray.GetWidth(), in.gray.GetHeight());
+            delete[] dithered;
+            return out;
+        }});
+        variants.push_back({"dither", "wavefront, 4 threads", kExact, [](const Inputs& in)
+        {
+            Image out(in.gray.GetWidth(), in.gray.GetHeight(), 1);
+            floydSteinbergDither(in.gray.GetData(), in.gray.GetWidth(), in.gray.GetHeight(), in.gray.GetStride(),
+                                 out.GetData(), out.GetStride(), DitherOptions{false, true}, in.wavefrontPool);
+            return out;
+        }});
+        variants.push_back({"dither", "DitherStream, 7 row strips", kExact, [](const Inputs& in)
+        {
+            Image out(in.gray.GetWidth(), in.gray.GetHeight(), 1);
+            std::unique_ptr<DitherStream> stream = createDitherStream(DiffusionKernel::FloydSteinberg, in.gray.GetWidth());
+            for (int y = 0; y < in.gray.GetHeight(); y += 7)
+            {
+                stream->Process(in.gray.GetRow(y), std::min(7, in.gray.GetHeight() - y), in.gray.GetStride(),
+                                out.GetRow(y), out.GetStride());
+            }
+            return out;
+        }});
+        variants.push_back({"dither", "ImagePipeline", kExact, [](const Inputs& in)
+        {
+            return std::move(runPipeline(in).floyd);
+        }});
+
+        return variants;
+    }
+
+    // ---- Checks ----
+
+    std::string goldenPath(const RegressOptions& options, const CorpusImage& corpus, const char* output)
+    {
+        std::string directory = options.goldenDirectory;
+        if (!directory.empty() && directory.back() != '/')
+            directory += '/';
+        return directory + syntheticPatternName(corpus.pattern) + "_" + std::to_string(corpus.width) + "x" +
+               std::to_string(corpus.height) + "_" + output + ".png";
+    }
+
+    // Empty string when 'actual' is within 'tolerance' of 'golden', otherwise what is wrong
+    std::string compareImages(const Image& golden, const Image& actual, const Tolerance& tolerance)
+    {
+        if (golden.GetWidth() != actual.GetWidth() || golden.GetHeight() != actual.GetHeight())
+        {
+            return "size " + std::to_string(actual.GetWidth()) + "x" + std::to_string(actual.GetHeight()) +
+                   ", golden is " + std::to_string(golden.GetWidth()) + "x" + std::to_string(golden.GetHeight());
+        }
+        int max_difference = 0;
+        long long differing = 0, first_x = -1, first_y = -1;
+        for (int y = 0; y < golden.GetHeight(); y++)
+        {
+            const unsigned char* g = golden.GetRow(y);
+            const unsigned char* a = actual.GetRow(y);
+            for (int x = 0; x < golden.GetWidth(); x++)
+            {
+                const int difference = std::abs(g[x] - a[x]);
+                if (difference == 0)
+                    continue;
+                if (differing++ == 0)
+                {
+                    first_x = x;
+                    first_y = y;
+                }
+                max_difference = std::max(max_difference, difference);
+            }
+        }
+        const double fraction = differing / ((double)golden.GetWidth() * golden.GetHeight());
+        if (max_difference <= tolerance.maxDifference && fraction <= tolerance.maxFraction)
+            return std::string();
+        std::ostringstream message;
+        message << differing << " pixels differ (" << std::setprecision(3) << fraction * 100 << "%), max by "
+                << max_difference << ", first at " << first_x << "," << first_y;
+        return message.str();
+    }
+
+    double medianMilliseconds(const Variant& variant, const Inputs& inputs, int runs)
+    {
+        std::vector<double> times;
+        for (int run = 0; run <= runs; run++)
+        {
+            const Clock::time_point start = Clock::now();
+            Image out = variant.run(inputs);
+            const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            if (out.IsEmpty())
+                return -1.0;
+            if (run > 0)    // the first run warms up
+                times.push_back(ms);
+        }
+        std::sort(times.begin(), times.end());
+        return times[times.size() / 2];
+    }
+
+    std::string variantKey(const Variant& variant)
+    {
+        return std::string(variant.output) + "/" + variant.name;
+    }
+
+    // "<output>/<variant>\t<MPix/s>" per line
+    std::map<std::string, double> readBaseline(const std::string& path, bool& ok)
+    {
+        std::map<std::string, double> baseline;
+        std::ifstream file(path);
+        ok = (bool)file;
+        std::string line;
+        while (std::getline(file, line))
+        {
+            const size_t tab = line.rfind('\t');
+            if (line.empty() || line[0] == '#' || tab == std::string::npos)
+                continue;
+            baseline[line.substr(0, tab)] = std::atof(line.c_str() + tab + 1);
+        }
+        return baseline;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    RegressOptions options;
+    for (int i = 1; i < argc; i++)
+    {
+        const bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--golden") == 0 && has_value)
+            options.goldenDirectory = argv[++i];
+        else if (strcmp(argv[i], "--update-golden") == 0)
+            options.updateGolden = true;
+        else if (strcmp(argv[i], "--no-perf") == 0)
+            options.perf = false;
+        else if (strcmp(argv[i], "--perf-size") == 0 && has_value)
+            options.perfSize = std::max(3, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--runs") == 0 && has_value)
+            options.runs = std::max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--baseline") == 0 && has_value)
+            options.baseline = argv[++i];
+        else if (strcmp(argv[i], "--save-baseline") == 0 && has_value)
+            options.saveBaseline = argv[++i];
+        else if (strcmp(argv[i], "--max-slowdown") == 0 && has_value)
+            options.maxSlowdown = atof(argv[++i]);
+        else
+        {
+            std::cerr << "Unknown option " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    if (options.updateGolden)
+    {
+        std::error_code error;
+        std::filesystem::create_directories(options.goldenDirectory, error);
+    }
+
+    const std::vector<Variant> variants = allVariants();
+    TileExecutor executor(ThreadPool::Global(), 64, 48);   // small tiles, so the corpus has many
+    ThreadPool wavefront_pool(4);
+    int failures = 0;
+
+    // Outputs against the golden images
+    for (const CorpusImage& corpus : kCorpus)
+    {
+        const Image rgba = makeSyntheticImage(corpus.pattern, corpus.width, corpus.height);
+        const Image gray = referenceGrayscale(rgba);
+        const Inputs inputs{rgba, gray, executor, wavefront_pool};
+
+        std::map<std::string, Image> goldens;
+        for (const Variant& variant : variants)
+        {
+            const std::string path = goldenPath(options, corpus, variant.output);
+            if (!goldens.count(variant.output))
+            {
+                // The first variant of every output is its reference
+                if (options.updateGolden && !variant.run(inputs).SavePNG(path, PngOptions{9, 0}))
+                {
+                    std::cout << "FAILED to write " << path << std::endl;
+                    return 1;
+                }
+                goldens[variant.output] = Image::Load(path, 1);
+            }
+            const Image& golden = goldens[variant.output];
+
+            const Image actual = variant.run(inputs);
+            std::string problem;
+            if (actual.IsEmpty())
+                continue;
+            if (golden.IsEmpty())
+                problem = "no golden image " + path;
+            else
+                problem = compareImages(golden, actual, variant.tolerance);
+            if (!problem.empty())
+            {
+                failures++;
+                std::cout << "FAIL  " << std::left << std::setw(12) << variant.output << std::setw(42) << variant.name
+                          << syntheticPatternName(corpus.pattern) << " " << corpus.width << "x" << corpus.height
+                          << ": " << problem << std::endl;
+            }
+        }
+    }
+    std::cout << variants.size() << " variants on " << sizeof(kCorpus) / sizeof(kCorpus[0]) << " images, "
+              << failures << " mismatches" << std::endl;
+    if (!options.perf)
+        return failures == 0 ? 0 : 1;
+
+    // Throughput against the baseline
+    bool have_baseline = false;
+    std::map<std::string, double> baseline;
+    if (!options.baseline.empty())
+    {
+        baseline = readBaseline(options.baseline, have_baseline);
+        if (!have_baseline)
+            std::cout << "No baseline in " << options.baseline << ", timings are not checked" << std::endl;
+    }
+
+    const Image rgba = makeSyntheticImage(SyntheticPattern::Fractal, options.perfSize, options.perfSize);
+    const Image gray = referenceGrayscale(rgba);
+    const Inputs inputs{rgba, gray, executor, wavefront_pool};
+    const double pixels = (double)options.perfSize * options.perfSize;
+
+    std::ostringstream saved;
+    saved << "# MPix/s at " << options.perfSize << "x" << options.perfSize << ", "
+          << ThreadPool::Global().GetThreadCount() << " threads, median of " << options.runs << " runs\n";
+    std::cout << std::endl << std::left << std::setw(56) << "variant" << std::right << std::setw(10) << "MPix/s"
+              << std::setw(12) << "baseline" << std::endl;
+    int slow = 0;
+    for (const Variant& variant : variants)
+    {
+        const double ms = medianMilliseconds(variant, inputs, options.runs);
+        if (ms < 0)
+            continue;
+        const double throughput = pixels / 1e3 / ms;
+        const std::string key = variantKey(variant);
+        saved << key << "\t" << std::fixed << std::setprecision(2) << throughput << "\n";
+
+        std::cout << std::left << std::setw(56) << key << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << throughput;
+        auto known = baseline.find(key);
+        if (known != baseline.end())
+        {
+            const bool too_slow = throughput < known->second * (1.0 - options.maxSlowdown / 100.0);
+            std::cout << std::setw(12) << known->second << (too_slow ? "  SLOWER" : "");
+            slow += too_slow ? 1 : 0;
+        }
+        std::cout << std::endl;
+    }
+
+    if (!options.saveBaseline.empty())
+    {
+        std::ofstream file(options.saveBaseline);
+        file << saved.str();
+        if (!file)
+        {
+            std::cout << "Failed to write " << options.saveBaseline << std::endl;
+            return 1;
+        }
+    }
+    if (have_baseline)
+        std::cout << slow << " variants more than " << options.maxSlowdown << "% below the baseline" << std::endl;
+    return failures == 0 && slow == 0 ? 0 : 1;
+}
@@ -0,0 +1,69 @@
+#include <AsyncImageWriter.h>
+#include <Profiler.h>
+
+#include <iostream>
+
+AsyncImageWriter::AsyncImageWriter(const PngOptions& options)
+    : m_Options(options), m_Stopping(false), m_Busy(false), m_Failures(0)
+{
+    m_Thread = std::thread(&AsyncImageWriter::WorkerLoop, this);
+}
+
+AsyncImageWriter::~AsyncImageWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stopping = true;
+    }
+    m_Condition.notify_all();
+    m_Thread.join();
+}
+
+void AsyncImageWriter::Write(const std::string& filepath, Image image)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Queue.emplace_back(filepath, std::move(image));
+    }
+    m_Condition.notify_one();
+}
+
+void AsyncImageWriter::Flush()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Drained.wait(lock, [this]() { return m_Queue.empty() && !m_Busy; });
+}
+
+int AsyncImageWriter::GetFailures()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Failures;
+}
+
+void AsyncImageWriter::WorkerLoop()
+{
+    Profiler::SetThreadName("image writer");
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    while (true)
+    {
+        m_Condition.wait(lock, [this]() { return m_Stopping || !m_Queue.empty(); });
+        if (m_Queue.empty())
+            return; // stopping and drained
+
+        std::pair<std::string, Image> job = std::move(m_Queue.front());
+        m_Queue.pop_front();
+        m_Busy = true;
+
+        lock.unlock();
+        bool ok = job.second.SavePNG(job.first, m_Options);
+        if (!ok)
+            std::cout << "Failed to write " << job.first << std::endl;
+        lock.lock();
+
+        m_Busy = false;
+        if (!ok)
+            m_Failures++;
+        if (m_Queue.empty())
+            m_Drained.notify_all();
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <Image.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+// Encodes and writes images on a background thread so the pipeline never waits for PNG deflate.
+// The deflate itself still spreads over the global pool.
+class AsyncImageWriter
+{
+    private:
+        PngOptions m_Options;
+        std::thread m_Thread;
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+        std::condition_variable m_Drained;
+        std::deque<std::pair<std::string, Image>> m_Queue;
+        bool m_Stopping;
+        bool m_Busy;
+        int m_Failures;
+    public:
+        AsyncImageWriter(const PngOptions& options = PngOptions());
+        // Waits for all queued writes
+        ~AsyncImageWriter();
+
+        AsyncImageWriter(const AsyncImageWriter&) = delete;
+        AsyncImageWriter& operator=(const AsyncImageWriter&) = delete;
+
+        // Queues a PNG write, the image is moved into the queue (pass a Clone() to keep it)
+        void Write(const std::string& filepath, Image image);
+
+        // Blocks until every queued image is on disk
+        void Flush();
+
+        // Number of writes that failed so far
+        int GetFailures();
+    private:
+        void WorkerLoop();
+};
@@ -0,0 +1,271 @@
+#include <BatchRunner.h>
+#include <BoundedQueue.h>
+#include <Profiler.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    double millisecondsSince(Clock::time_point start, Clock::time_point end = Clock::now())
+    {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    struct DecodedJob
+    {
+        Clock::time_point start;
+        BatchImageTiming timing;
+        size_t index;
+        Image input;
+    };
+
+    struct ProcessedJob
+    {
+        Clock::time_point start;
+        BatchImageTiming timing;
+        size_t index;
+        PipelineResult result;
+    };
+
+    std::string lowercase(std::string text)
+    {
+        std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+        return text;
+    }
+
+    bool isImageFile(const std::filesystem::path& path)
+    {
+        const std::string extension = lowercase(path.extension().string());
+        static const char* known[] = {".png", ".jpg", ".jpeg", ".bmp", ".tga", ".psd", ".gif",
+                                      ".hdr", ".pic", ".pgm", ".ppm", ".pnm", ".pam"};
+        for (const char* candidate : known)
+        {
+            if (extension == candidate)
+                return true;
+        }
+        return false;
+    }
+
+    // Output name of every input: its stem, or when other inputs share the stem (scan.png
+    // and scan.jpg, a/001.png and b/001.png) the stem and the input's index, so no image
+    // overwrites another's outputs. Compared without case for case-insensitive file systems.
+    std::vector<std::string> outputStems(const std::vector<std::string>& inputs)
+    {
+        std::vector<std::string> stems;
+        std::unordered_map<std::string, int> counts;
+        for (const std::string& input : inputs)
+        {
+            stems.push_back(std::filesystem::path(input).stem().string());
+            counts[lowercase(stems.back())]++;
+        }
+
+        std::set<std::string> taken;
+        for (const std::string& stem : stems)
+        {
+            if (counts[lowercase(stem)] == 1)
+                taken.insert(lowercase(stem));
+        }
+        for (size_t i = 0; i < stems.size(); i++)
+        {
+            if (counts[lowercase(stems[i])] == 1)
+                continue;
+            std::string name = stems[i] + "_" + std::to_string(i);
+            while (!taken.insert(lowercase(name)).second)
+                name += "_" + std::to_string(i);
+            stems[i] = name;
+        }
+        return stems;
+    }
+}
+
+std::vector<std::string> collectBatchInputs(const std::string& path)
+{
+    std::vector<std::string> inputs;
+    std::error_code error;
+    if (std::filesystem::is_directory(path, error))
+    {
+        for (const auto& entry : std::filesystem::directory_iterator(path, error))
+        {
+            if (entry.is_regular_file(error) && isImageFile(entry.path()))
+                inputs.push_back(entry.path().string());
+        }
+        std::sort(inputs.begin(), inputs.end());
+        return inputs;
+    }
+
+    std::ifstream list(path);
+    std::string line;
+    while (std::getline(list, line))
+    {
+        // Trailing \r from lists written on Windows
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' '))
+            line.pop_back();
+        if (!line.empty() && line[0] != '#')
+            inputs.push_back(line);
+    }
+    return inputs;
+}
+
+BatchReport runBatch(const std::vector<std::string>& inputs, TileExecutor& executor, const BatchOptions& options)
+{
+    BatchReport report;
+    const Clock::time_point batch_start = Clock::now();
+
+    std::error_code error;
+    std::filesystem::create_directories(options.outputDirectory, error);
+    std::string output_directory = options.outputDirectory;
+    if (!output_directory.empty() && output_directory.back() != '/')
+        output_directory += '/';
+    const std::vector<std::string> output_stems = outputStems(inputs);
+
+    PipelineOptions pipeline_options = options.pipeline;
+    pipeline_options.writeOutputs = false;
+    pipeline_options.logStages = false;
+    ImagePipeline pipeline(executor, pipeline_options);
+
+    BoundedQueue<DecodedJob> decoded(options.queueDepth);
+    BoundedQueue<ProcessedJob> processed(options.queueDepth);
+    std::mutex report_mutex;
+
+    auto finish = [&](const BatchImageTiming& timing)
+    {
+        std::lock_guard<std::mutex> lock(report_mutex);
+        report.images.push_back(timing);
+        if (!timing.ok)
+            report.failed++;
+        else
+            report.megapixels += timing.width * (double)timing.height / 1e6;
+        if (options.logImages)
+        {
+            std::cout << (timing.ok ? "done   " : "FAILED ") << timing.path << std::fixed << std::setprecision(1)
+                      << "  decode " << timing.decodeMs << " ms, filters " << timing.processMs
+                      << " ms, encode " << timing.encodeMs << " ms, latency " << timing.latencyMs << " ms" << std::endl;
+        }
+    };
+
+    // Decode: threads take the next input in order
+    std::atomic<size_t> next_input{0};
+    std::atomic<int> decoders_left{std::max(1, options.decodeThreads)};
+    std::vector<std::thread> decoders;
+    for (int i = 0; i < std::max(1, options.decodeThreads); i++)
+    {
+        decoders.emplace_back([&]()
+        {
+            Profiler::SetThreadName("batch decoder");
+            size_t index;
+            while ((index = next_input.fetch_add(1)) < inputs.size())
+            {
+                DecodedJob job;
+                job.start = Clock::now();
+                job.timing.path = inputs[index];
+                job.index = index;
+                job.input = Image::Load(inputs[index], 4);
+                job.timing.decodeMs = millisecondsSince(job.start);
+                if (job.input.IsEmpty())
+                {
+                    job.timing.latencyMs = job.timing.decodeMs;
+                    finish(job.timing);
+                    continue;
+                }
+                job.timing.width = job.input.GetWidth();
+                job.timing.height = job.input.GetHeight();
+                if (!decoded.Push(std::move(job)))
+                    break;
+            }
+            if (decoders_left.fetch_sub(1) == 1)
+                decoded.Close();
+        });
+    }
+
+    // Encode: every output of an image is written by the same thread
+    std::vector<std::thread> encoders;
+    for (int i = 0; i < std::max(1, options.encodeThreads); i++)
+    {
+        encoders.emplace_back([&]()
+        {
+            Profiler::SetThreadName("batch encoder");
+            ProcessedJob job;
+            while (processed.Pop(job))
+            {
+                const Clock::time_point encode_start = Clock::now();
+                const std::string stem = output_directory + output_stems[job.index];
+                auto save = [&](const Image& image, const char* stage)
+                {
+                    return options.rawOutputs ? image.SaveRaw(stem + stage + ".pam") : image.SavePNG(stem + stage + ".png", options.pipeline.png);
+                };
+                bool ok = save(job.result.grayscale, "_Grayscale");
+                ok = save(job.result.canny, "_Canny") && ok;
+                ok = save(job.result.halftone, "_Haftone") && ok;
+                ok = save(job.result.floyd, "_FloyedSteinberg") && ok;
+                job.timing.ok = ok;
+                job.timing.encodeMs = millisecondsSince(encode_start);
+                job.timing.latencyMs = millisecondsSince(job.start);
+                job.result = PipelineResult();  // back to the frame pool before the next pop
+                finish(job.timing);
+            }
+        });
+    }
+
+    // Filters on this thread, each image is already spread over the pool
+    DecodedJob job;
+    while (decoded.Pop(job))
+    {
+        const Clock::time_point process_start = Clock::now();
+        ProcessedJob out;
+        out.start = job.start;
+        out.timing = job.timing;
+        out.index = job.index;
+        out.result = pipeline.Run(job.input);
+        out.timing.processMs = millisecondsSince(process_start);
+        job.input = Image();
+        processed.Push(std::move(out));
+    }
+    processed.Close();
+
+    for (std::thread& thread : decoders)
+        thread.join();
+    for (std::thread& thread : encoders)
+        thread.join();
+
+    report.seconds = millisecondsSince(batch_start) / 1000.0;
+    return report;
+}
+
+void printBatchReport(const BatchReport& report, std::ostream& out)
+{
+    const int total = (int)report.images.size();
+    const int ok = total - report.failed;
+    out << std::fixed << std::setprecision(2);
+    out << total << " images (" << report.failed << " failed) in " << report.seconds << " s" << std::endl;
+    if (report.seconds > 0)
+    {
+        out << "throughput: " << ok / report.seconds << " images/s, "
+            << report.megapixels / report.seconds << " MPix/s" << std::endl;
+    }
+
+    std::vector<double> latencies;
+    for (const BatchImageTiming& timing : report.images)
+    {
+        if (timing.ok)
+            latencies.push_back(timing.latencyMs);
+    }
+    if (latencies.empty())
+        return;
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) { return latencies[std::min(latencies.size() - 1, (size_t)(p * latencies.size()))]; };
+    out << "latency: p50 " << percentile(0.5) << " ms, p95 " << percentile(0.95)
+        << " ms, max " << latencies.back() << " ms" << std::endl;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <ImagePipeline.h>
+#include <TileExecutor.h>
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct BatchOptions
+{
+    // Outputs land here as <input name>_<stage>.png. Inputs sharing a name (scan.png and
+    // scan.jpg, a/001.png and b/001.png) get their index in the input list appended to it.
+    std::string outputDirectory = "out/";
+
+    int decodeThreads = 2;
+    int encodeThreads = 2;
+    // Images buffered between two stages, bounds memory use
+    int queueDepth = 4;
+
+    // Uncompressed PAMs instead of PNGs
+    bool rawOutputs = false;
+
+    // Filter settings. Writing and logging are handled by the batch itself.
+    PipelineOptions pipeline;
+
+    // One line per finished image
+    bool logImages = true;
+};
+
+struct BatchImageTiming
+{
+    std::string path;
+    bool ok = false;
+    int width = 0, height = 0;
+    double decodeMs = 0, processMs = 0, encodeMs = 0;
+    // From the start of the decode to the last output written
+    double latencyMs = 0;
+};
+
+struct BatchReport
+{
+    std::vector<BatchImageTiming> images;   // in completion order
+    int failed = 0;
+    double seconds = 0;
+    double megapixels = 0;
+};
+
+// Every decodable image (png, jpg, bmp, tga, psd, gif, hdr, pic, pnm, pam) in a directory, or
+// every non-empty line of a text file that doesn't start with '#'. Sorted for directories.
+std::vector<std::string> collectBatchInputs(const std::string& path);
+
+// Runs decode -> filter chain -> PNG encode as three stages joined by bounded queues, so
+// reading and writing files overlap with the filters. Decode and encode run on their own
+// threads, the filter stage runs on the calling thread and spreads each image over the
+// executor's pool.
+BatchReport runBatch(const std::vector<std::string>& inputs, TileExecutor& executor,
+                     const BatchOptions& options = BatchOptions());
+
+// Totals, throughput and latency percentiles
+void printBatchReport(const BatchReport& report, std::ostream& out);
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+// Multi-producer, multi-consumer FIFO holding at most 'capacity' items. Producers block
+// while it is full, so a fast stage can't run arbitrarily far ahead of a slow one.
+template <typename T>
+class BoundedQueue
+{
+    private:
+        std::deque<T> m_Items;
+        size_t m_Capacity;
+        bool m_Closed;
+        std::mutex m_Mutex;
+        std::condition_variable m_NotFull;
+        std::condition_variable m_NotEmpty;
+    public:
+        BoundedQueue(size_t capacity)
+            : m_Capacity(capacity > 0 ? capacity : 1), m_Closed(false) {}
+
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+        // Blocks while full. Returns false (dropping 'item') once the queue is closed.
+        bool Push(T item)
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_NotFull.wait(lock, [this]() { return m_Closed || m_Items.size() < m_Capacity; });
+            if (m_Closed)
+                return false;
+            m_Items.push_back(std::move(item));
+            lock.unlock();
+            m_NotEmpty.notify_one();
+            return true;
+        }
+
+        // Blocks while empty. Returns false when the queue is closed and drained.
+        bool Pop(T& item)
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_NotEmpty.wait(lock, [this]() { return m_Closed || !m_Items.empty(); });
+            if (m_Items.empty())
+                return false;
+            item = std::move(m_Items.front());
+            m_Items.pop_front();
+            lock.unlock();
+            m_NotFull.notify_one();
+            return true;
+        }
+
+        // No more pushes, consumers finish what is queued and then see Pop() fail
+        void Close()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Closed = true;
+            }
+            m_NotFull.notify_all();
+            m_NotEmpty.notify_all();
+        }
+};
@@ -0,0 +1,226 @@
+#include <CannyEngine.h>
+#include <Filters.h>
+#include <GaussianBlur.h>
+#include <HysteresisEngine.h>
+#include <RecursiveGaussian.h>
+#include <Sobel.h>
+
+#include <algorithm>
+#include <cstring>
+
+CannyEngine::CannyEngine(int width, const CannyParams& params)
+    : m_Width(width), m_Params(params), m_Height(0), m_Pushed(0), m_BlurRows(true),
+      m_Blur(3 * width), m_Magnitude(3 * width), m_Direction(3 * width), m_Edges(3 * width)
+{
+}
+
+void CannyEngine::Process(const unsigned char* src, unsigned char* dst, int height)
+{
+    const int width = m_Width;
+    if (width < 3 || height < 3)
+    {
+        // No interior pixels, every stage after the blur outputs zeros
+        std::memset(dst, 0, (size_t)width * height);
+        return;
+    }
+
+    // Row k of the source becomes available at step k. Each stage lags the previous one
+    // by a row because it needs the row below, so output row k - 4 is final at step k.
+    // Source row r is last read by the blur of row r + 1 (step r + 2), which makes it
+    // safe to write dst row r at step r + 4 even when dst aliases src.
+    m_Height = height;
+    m_BlurRows = m_Params.blur == CannyBlur::Gaussian3x3;
+    size_t stride = width;
+    Image blurred;
+    if (m_Params.blur == CannyBlur::Recursive)
+    {
+        // Its reach is far beyond the row rings, the whole frame is blurred up front
+        blurred = Image(width, height, 1);
+        recursiveGaussian(ConstImageView(src, width, height), blurred.View(), m_Params.sigma);
+        src = blurred.GetData();
+        stride = blurred.GetStride();
+    }
+
+    for (int k = 0; k < height + 4; k++)
+    {
+        const int y = std::min(std::max(k - 1, 0), height - 1);
+        const unsigned char* row = src + y * stride;
+        Step(k, y > 0 ? row - stride : row, row, y < height - 1 ? row + stride : row,
+             dst + (size_t)std::max(k - 4, 0) * width);
+    }
+
+    if (m_Params.hysteresis == HysteresisMode::Connected)
+        hysteresisTrace(dst, dst, width, height);
+}
+
+void CannyEngine::Begin(int height)
+{
+    m_Height = height;
+    m_Pushed = 0;
+    m_BlurRows = m_Params.blur != CannyBlur::None;
+    m_Source.assign(3 * (size_t)m_Width, 0);
+    m_Output.assign(m_Width, 0);
+}
+
+void CannyEngine::PushRow(const unsigned char* row, const RowSink& sink)
+{
+    const int k = m_Pushed++;
+    std::memcpy(RingRow(m_Source, k), row, m_Width);
+    if (m_Width < 3 || m_Height < 3)
+        return;
+
+    // Blur row k - 1 reads source rows k - 2, k - 1 and k, all still in the ring
+    const int y = std::max(k - 1, 0);
+    Step(k, RingRow(m_Source, std::max(y - 1, 0)), RingRow(m_Source, y), RingRow(m_Source, k), m_Output.data());
+    if (k >= 4)
+        sink(m_Output.data(), k - 4);
+}
+
+void CannyEngine::Finish(const RowSink& sink)
+{
+    if (m_Width < 3 || m_Height < 3)
+    {
+        std::memset(m_Output.data(), 0, m_Width);
+        for (int y = 0; y < m_Height; y++)
+            sink(m_Output.data(), y);
+        return;
+    }
+
+    for (int k = m_Height; k < m_Height + 4; k++)
+    {
+        const int y = std::min(k - 1, m_Height - 1);
+        Step(k, RingRow(m_Source, y - 1), RingRow(m_Source, y), RingRow(m_Source, y), m_Output.data());
+        if (k >= 4)
+            sink(m_Output.data(), k - 4);
+    }
+}
+
+void CannyEngine::Step(int k, const unsigned char* up, const unsigned char* row, const unsigned char* down, unsigned char* out)
+{
+    const int height = m_Height;
+    if (k - 1 >= 0 && k - 1 < height)
+        BlurRow(up, row, down, k - 1);
+    if (k - 2 >= 0 && k - 2 < height)
+        GradientRow(k - 2);
+    if (k - 3 >= 0 && k - 3 < height)
+        SuppressRow(k - 3);
+    if (k - 4 < 0 || k - 4 >= height)
+        return;
+    if (m_Params.hysteresis == HysteresisMode::Neighbours)
+        HysteresisRow(out, k - 4);
+    else
+        EdgeRow(out, k - 4);
+}
+
+void CannyEngine::BlurRow(const unsigned char* up, const unsigned char* row, const unsigned char* down, int y)
+{
+    const int width = m_Width;
+    unsigned char* out = RingRow(m_Blur, y);
+
+    // Border rows and columns keep the source value (same as noise()), pre-blurred rows pass through
+    if (!m_BlurRows || y == 0 || y == m_Height - 1)
+    {
+        std::memcpy(out, row, width);
+        return;
+    }
+
+    out[0] = row[0];
+    gaussianRow3x3(up, row, down, out, width);
+    out[width - 1] = row[width - 1];
+}
+
+void CannyEngine::GradientRow(int y)
+{
+    const int width = m_Width;
+    unsigned char* mag = RingRow(m_Magnitude, y);
+    unsigned char* dir = RingRow(m_Direction, y);
+
+    std::memset(mag, 0, width);
+    std::memset(dir, 0, width);
+    if (y == 0 || y == m_Height - 1)
+        return;
+
+    sobelRow(RingRow(m_Blur, y - 1), RingRow(m_Blur, y), RingRow(m_Blur, y + 1), mag, dir, width, m_Params.norm);
+}
+
+void CannyEngine::SuppressRow(int y)
+{
+    const int width = m_Width;
+    unsigned char* out = RingRow(m_Edges, y);
+
+    std::memset(out, 0, width);
+    if (y == 0 || y == m_Height - 1)
+        return;
+
+    const unsigned char* up = RingRow(m_Magnitude, y - 1);
+    const unsigned char* row = RingRow(m_Magnitude, y);
+    const unsigned char* down = RingRow(m_Magnitude, y + 1);
+    const unsigned char* dir = RingRow(m_Direction, y);
+    const unsigned char low = m_Params.low, high = m_Params.high;
+
+    for (int j = 1; j < width - 1; j++)
+    {
+        unsigned char neighbor1, neighbor2;
+        switch (dir[j])
+        {
+            case EDGE_DIR_0:
+                neighbor1 = row[j + 1];
+                neighbor2 = row[j - 1];
+                break;
+            case EDGE_DIR_90:
+                neighbor1 = down[j];
+                neighbor2 = up[j];
+                break;
+            case EDGE_DIR_135:
+                neighbor1 = down[j - 1];
+                neighbor2 = up[j + 1];
+                break;
+            default:
+                neighbor1 = down[j + 1];
+                neighbor2 = up[j - 1];
+                break;
+        }
+
+        // Suppressed pixels are 0 which always classifies as a non-edge
+        unsigned char pixel = row[j];
+        if (neighbor1 <= pixel && neighbor2 <= pixel && pixel > low)
+            out[j] = pixel > high ? 255 : 1;
+    }
+}
+
+void CannyEngine::HysteresisRow(unsigned char* out, int y)
+{
+    const int width = m_Width;
+
+    std::memset(out, 0, width);
+    if (y == 0 || y == m_Height - 1)
+        return;
+
+    const unsigned char* up = RingRow(m_Edges, y - 1);
+    const unsigned char* row = RingRow(m_Edges, y);
+    const unsigned char* down = RingRow(m_Edges, y + 1);
+
+    for (int j = 1; j < width - 1; j++)
+    {
+        if (row[j] == 255)
+        {
+            out[j] = 255;
+        }
+        else if (row[j] == 1)
+        {
+            // Weak edge survives when it touches a strong one
+            if (up[j - 1] == 255 || up[j] == 255 || up[j + 1] == 255 ||
+                row[j - 1] == 255 || row[j + 1] == 255 ||
+                down[j - 1] == 255 || down[j] == 255 || down[j + 1] == 255)
+            {
+                out[j] = 255;
+            }
+        }
+    }
+}
+
+void CannyEngine::EdgeRow(unsigned char* out, int y)
+{
+    // The suppressed row is already 0 / 1 / 255 with zero borders
+    std::memcpy(out, RingRow(m_Edges, y), m_Width);
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <Sobel.h>
+
+#include <functional>
+#include <vector>
+
+enum class HysteresisMode
+{
+    Neighbours,     // single 3x3 pass, weak pixels must touch a strong one (Hysteresis())
+    Connected,      // weak pixels connected to a strong one by any chain (hysteresisTrace())
+    None            // output the thresholded map: 0, 1 (weak) or 255 (strong)
+};
+
+enum class CannyBlur
+{
+    Gaussian3x3,    // the fixed kernel of noise(), row by row
+    Recursive,      // RecursiveGaussian of any sigma over the whole frame first
+    None            // the input is already smooth
+};
+
+struct CannyParams
+{
+    // Pixels above 'high' are strong edges, pixels in (low, high] are weak edges.
+    // The defaults reproduce findArea(): everything above 168 is strong, nothing is weak.
+    unsigned char low = 168;
+    unsigned char high = 168;
+
+    // L1 skips the square root at the cost of accuracy on diagonal gradients
+    GradientNorm norm = GradientNorm::L2;
+
+    HysteresisMode hysteresis = HysteresisMode::Connected;
+
+    // Pre-blur. Noisy scans want Recursive with sigma 2 - 10, which costs the same for any sigma.
+    CannyBlur blur = CannyBlur::Gaussian3x3;
+    float sigma = 2.0f;
+};
+
+// Streaming Canny: every source row is pushed through blur, gradient, non-maximum
+// suppression, thresholding and hysteresis while it is still in cache. Each stage keeps
+// a ring of 3 rows, so the working set is ~12 rows instead of several full frames.
+// With HysteresisMode::Neighbours the output matches noise() -> gradientCalculation() ->
+// Non_MaxSuppression() -> Thresholding() -> Hysteresis() run one after the other.
+// Connected hysteresis needs the whole edge map, so it runs once all rows are out.
+//
+// Rows can also be pushed one at a time (Begin / PushRow / Finish) when the frame never
+// exists in memory as a whole. Finished rows go to a sink in order, 4 rows behind the
+// input. Connected hysteresis can't be streamed: its rows come out thresholded
+// (0 / 1 / 255) and it is up to the caller to trace them. Neither can the recursive
+// blur, which needs whole columns: streamed rows get the 3x3 kernel instead.
+class CannyEngine
+{
+    public:
+        // Called with every finished row (width bytes) and its index
+        typedef std::function<void(const unsigned char* row, int y)> RowSink;
+    private:
+        int m_Width;
+        CannyParams m_Params;
+
+        // Streaming state: frame height and source rows pushed so far
+        int m_Height;
+        int m_Pushed;
+        // False when the rows reaching BlurRow() are blurred already
+        bool m_BlurRows;
+
+        // Row rings (3 rows each)
+        std::vector<unsigned char> m_Source;
+        std::vector<unsigned char> m_Blur;
+        std::vector<unsigned char> m_Magnitude;
+        std::vector<unsigned char> m_Direction;
+        std::vector<unsigned char> m_Edges;
+        std::vector<unsigned char> m_Output;
+    public:
+        CannyEngine(int width, const CannyParams& params = CannyParams());
+
+        // Runs the whole chain over a width x height frame. 'dst' may alias 'src'.
+        void Process(const unsigned char* src, unsigned char* dst, int height);
+
+        // Starts a frame of 'height' rows, then PushRow() every row top to bottom and
+        // Finish() to flush the last 4
+        void Begin(int height);
+        void PushRow(const unsigned char* row, const RowSink& sink);
+        void Finish(const RowSink& sink);
+
+        inline int GetWidth() const { return m_Width; }
+    private:
+        inline unsigned char* RingRow(std::vector<unsigned char>& ring, int y) { return &ring[(y % 3) * m_Width]; }
+
+        // Everything that became possible once source row k is in: blur row k - 1 from
+        // the given source rows, gradient k - 2, suppression k - 3 and output row k - 4
+        // into 'out'. k runs to height + 3 to drain the stages.
+        void Step(int k, const unsigned char* up, const unsigned char* row, const unsigned char* down, unsigned char* out);
+
+        void BlurRow(const unsigned char* up, const unsigned char* row, const unsigned char* down, int y);
+        void GradientRow(int y);
+        void SuppressRow(int y);
+        void HysteresisRow(unsigned char* out, int y);
+        void EdgeRow(unsigned char* out, int y);
+};
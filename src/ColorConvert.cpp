@@ -0,0 +1,114 @@
+#include <ColorConvert.h>
+
+#include <cstring>
+
+static void lumaRowScalar(const unsigned char* src, PixelFormat format, unsigned char* dst, int from, int width)
+{
+    const int bpp = bytesPerPixel(format);
+    for (int i = from; i < width; i++)
+    {
+        const unsigned char* p = src + (size_t)i * bpp;
+        if (format == PixelFormat::BGRA)
+            dst[i] = lumaQ15(p[2], p[1], p[0]);
+        else
+            dst[i] = lumaQ15(p[0], p[1], p[2]);
+    }
+}
+
+#if defined(GRAPHICS_SSE2)
+// 4 pixels held as 32 bit lanes [c0 c1 c2 x] -> 4 luma values in 32 bit lanes
+static inline __m128i lumaOf4(__m128i pixels, __m128i weights)
+{
+    const __m128i zero = _mm_setzero_si128();
+    // c0 * w0 + c1 * w1 and c2 * w2 + x * 0 for each pixel
+    __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(pixels, zero), weights);
+    __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(pixels, zero), weights);
+    __m128 even = _mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(2, 0, 2, 0));
+    __m128 odd = _mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(3, 1, 3, 1));
+    return _mm_srli_epi32(_mm_add_epi32(_mm_castps_si128(even), _mm_castps_si128(odd)), 15);
+}
+
+static inline int load32(const unsigned char* p)
+{
+    int v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+static int lumaRowSSE2(const unsigned char* src, PixelFormat format, unsigned char* dst, int width)
+{
+    const __m128i weights = format == PixelFormat::BGRA
+        ? _mm_setr_epi16(3736, 19235, 9794, 0, 3736, 19235, 9794, 0)
+        : _mm_setr_epi16(9794, 19235, 3736, 0, 9794, 19235, 3736, 0);
+
+    int i = 0;
+    if (format == PixelFormat::RGBA || format == PixelFormat::BGRA)
+    {
+        // 16 pixels (64 bytes) per step
+        for (; i + 16 <= width; i += 16)
+        {
+            const __m128i* p = (const __m128i*)(src + (size_t)i * 4);
+            __m128i y0 = lumaOf4(_mm_loadu_si128(p + 0), weights);
+            __m128i y1 = lumaOf4(_mm_loadu_si128(p + 1), weights);
+            __m128i y2 = lumaOf4(_mm_loadu_si128(p + 2), weights);
+            __m128i y3 = lumaOf4(_mm_loadu_si128(p + 3), weights);
+            __m128i y01 = _mm_packs_epi32(y0, y1);
+            __m128i y23 = _mm_packs_epi32(y2, y3);
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(y01, y23));
+        }
+    }
+    else if (format == PixelFormat::RGB)
+    {
+        // Gather each 3 byte pixel with a 4 byte load (the 4th byte gets weight 0).
+        // The last pixel is left to the scalar loop so nothing past the row is read.
+        for (; i + 8 < width; i += 8)
+        {
+            const unsigned char* p = src + (size_t)i * 3;
+            __m128i a = _mm_setr_epi32(load32(p), load32(p + 3), load32(p + 6), load32(p + 9));
+            __m128i b = _mm_setr_epi32(load32(p + 12), load32(p + 15), load32(p + 18), load32(p + 21));
+            __m128i y = _mm_packs_epi32(lumaOf4(a, weights), lumaOf4(b, weights));
+            _mm_storel_epi64((__m128i*)(dst + i), _mm_packus_epi16(y, y));
+        }
+    }
+    return i;
+}
+#endif
+
+void lumaRow(const unsigned char* src, PixelFormat format, unsigned char* dst, int width, SimdLevel level)
+{
+    if (format == PixelFormat::Gray)
+    {
+        std::memcpy(dst, src, width);
+        return;
+    }
+    if (format == PixelFormat::GrayAlpha)
+    {
+        for (int i = 0; i < width; i++)
+            dst[i] = src[(size_t)i * 2];
+        return;
+    }
+
+    int i = 0;
+#if defined(GRAPHICS_SSE2)
+    if (supportedSimdLevel(level) != SimdLevel::Scalar)
+        i = lumaRowSSE2(src, format, dst, width);
+#endif
+    lumaRowScalar(src, format, dst, i, width);
+}
+
+void lumaImage(const unsigned char* src, int srcStride, PixelFormat format,
+               unsigned char* dst, int dstStride, int width, int height, ThreadPool& pool)
+{
+    if (srcStride == 0)
+        srcStride = width * bytesPerPixel(format);
+    if (dstStride == 0)
+        dstStride = width;
+
+    // Bands of at least ~64K pixels so small images don't pay for the hand-off
+    int grain = width > 0 ? (1 << 16) / width + 1 : 1;
+    pool.ParallelRanges(height, grain, [&](int first, int last)
+    {
+        for (int y = first; y < last; y++)
+            lumaRow(src + (size_t)y * srcStride, format, dst + (size_t)y * dstStride, width);
+    });
+}
@@ -0,0 +1,691 @@
+#include <Deflate.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    const int kWindow = 32768;
+    const int kMinMatch = 3;
+    const int kMaxMatch = 258;
+    const int kHashBits = 15;
+    // Symbols per block before the codes are rebuilt for the next one
+    const size_t kBlockSymbols = 1 << 15;
+
+    // zlib's configuration table
+    struct LevelParams
+    {
+        int good;       // the lazy search tries a quarter of the chain after a match this long
+        int lazy;       // shorter matches are checked against the next position (0: greedy)
+        int nice;       // a match this long ends the search
+        int chain;      // hash chain entries tried per position
+    };
+
+    const LevelParams kLevels[10] = {
+        {0, 0, 0, 0},
+        {4, 0, 8, 4}, {4, 0, 16, 8}, {4, 0, 32, 32},
+        {4, 4, 16, 16}, {8, 16, 32, 32}, {8, 16, 128, 128},
+        {8, 32, 128, 256}, {32, 128, 258, 1024}, {32, 258, 258, 4096}};
+
+    const unsigned short kLengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                            35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    const unsigned char kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                            3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    const unsigned short kDistanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385,
+                                              513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    const unsigned char kDistanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7,
+                                              8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+    // Order the code length code lengths are sent in
+    const unsigned char kCodeLengthOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+    struct CodeTables
+    {
+        unsigned char lengthCode[kMaxMatch + 1];    // match length -> length code - 257
+        unsigned char distanceCode[512];            // see distanceCodeOf()
+        unsigned int crc[4][256];                   // slicing by 4
+
+        CodeTables()
+        {
+            for (int code = 0; code < 28; code++)
+            {
+                for (int length = kLengthBase[code]; length < kLengthBase[code] + (1 << kLengthExtra[code]); length++)
+                    lengthCode[length] = (unsigned char)code;
+            }
+            lengthCode[kMaxMatch] = 28;
+
+            // Distances up to 256 directly, longer ones by (distance - 1) / 128
+            for (int code = 0; code < 30; code++)
+            {
+                for (int distance = kDistanceBase[code]; distance < kDistanceBase[code] + (1 << kDistanceExtra[code]); distance++)
+                {
+                    if (distance <= 256)
+                        distanceCode[distance - 1] = (unsigned char)code;
+                    else
+                        distanceCode[256 + ((distance - 1) >> 7)] = (unsigned char)code;
+                }
+            }
+
+            for (unsigned int i = 0; i < 256; i++)
+            {
+                unsigned int c = i;
+                for (int k = 0; k < 8; k++)
+                    c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                crc[0][i] = c;
+            }
+            for (unsigned int i = 0; i < 256; i++)
+            {
+                for (int t = 1; t < 4; t++)
+                    crc[t][i] = (crc[t - 1][i] >> 8) ^ crc[0][crc[t - 1][i] & 0xFF];
+            }
+        }
+    };
+
+    const CodeTables& tables()
+    {
+        static const CodeTables instance;
+        return instance;
+    }
+
+    inline int distanceCodeOf(const CodeTables& t, int distance)
+    {
+        return distance <= 256 ? t.distanceCode[distance - 1] : t.distanceCode[256 + ((distance - 1) >> 7)];
+    }
+
+    // Literal when distance is 0, otherwise a match of 'value' bytes
+    struct Symbol
+    {
+        unsigned short value;
+        unsigned short distance;
+    };
+
+    // Deflate packs bits starting with the least significant one
+    class BitWriter
+    {
+        private:
+            std::vector<unsigned char>& m_Out;
+            unsigned long long m_Bits;
+            int m_Count;
+        public:
+            BitWriter(std::vector<unsigned char>& out)
+                : m_Out(out), m_Bits(0), m_Count(0) {}
+
+            // At most 32 bits at once
+            inline void Put(unsigned int bits, int count)
+            {
+                m_Bits |= (unsigned long long)bits << m_Count;
+                m_Count += count;
+                if (m_Count >= 32)
+                {
+                    const unsigned char bytes[4] = {(unsigned char)m_Bits, (unsigned char)(m_Bits >> 8),
+                                                    (unsigned char)(m_Bits >> 16), (unsigned char)(m_Bits >> 24)};
+                    m_Out.insert(m_Out.end(), bytes, bytes + 4);
+                    m_Bits >>= 32;
+                    m_Count -= 32;
+                }
+            }
+
+            // Pads the last byte with zeros
+            void Align()
+            {
+                while (m_Count > 0)
+                {
+                    m_Out.push_back((unsigned char)m_Bits);
+                    m_Bits >>= 8;
+                    m_Count = std::max(0, m_Count - 8);
+                }
+                m_Bits = 0;
+            }
+
+            void PutBytes(const unsigned char* data, size_t length)
+            {
+                m_Out.insert(m_Out.end(), data, data + length);
+            }
+    };
+
+    // Huffman code lengths no longer than 'limit' bits. Frequencies are halved until the
+    // tree fits, which costs a little ratio on the rare blocks that need it.
+    void buildLengths(const unsigned int* frequencies, int count, int limit, unsigned char* lengths)
+    {
+        std::vector<unsigned int> weights(frequencies, frequencies + count);
+        std::vector<int> leaves;
+        std::vector<unsigned long long> weight;
+        std::vector<int> parent;
+        std::memset(lengths, 0, count);
+
+        while (true)
+        {
+            leaves.clear();
+            for (int i = 0; i < count; i++)
+            {
+                if (weights[i] > 0)
+                    leaves.push_back(i);
+            }
+            const int n = (int)leaves.size();
+            if (n == 0)
+                return;
+            if (n == 1)
+            {
+                lengths[leaves[0]] = 1;
+                return;
+            }
+            std::stable_sort(leaves.begin(), leaves.end(), [&](int a, int b) { return weights[a] < weights[b]; });
+
+            // Two queue construction: leaves in weight order, inner nodes are created in weight order
+            weight.assign(2 * n - 1, 0);
+            parent.assign(2 * n - 1, 0);
+            for (int i = 0; i < n; i++)
+                weight[i] = weights[leaves[i]];
+            int next_leaf = 0, next_inner = n;
+            for (int node = n; node < 2 * n - 1; node++)
+            {
+                int children[2];
+                for (int& child : children)
+                {
+                    if (next_leaf < n && (next_inner >= node || weight[next_leaf] <= weight[next_inner]))
+                        child = next_leaf++;
+                    else
+                        child = next_inner++;
+                }
+                weight[node] = weight[children[0]] + weight[children[1]];
+                parent[children[0]] = parent[children[1]] = node;
+            }
+
+            // Depths top down: the root is the last node and parents come after their children
+            std::vector<int> depth(2 * n - 1, 0);
+            int deepest = 0;
+            for (int node = 2 * n - 3; node >= 0; node--)
+            {
+                depth[node] = depth[parent[node]] + 1;
+                deepest = std::max(deepest, depth[node]);
+            }
+            if (deepest <= limit)
+            {
+                for (int i = 0; i < n; i++)
+                    lengths[leaves[i]] = (unsigned char)depth[i];
+                return;
+            }
+            for (unsigned int& w : weights)
+            {
+                if (w > 0)
+                    w = std::max(1u, w >> 1);
+            }
+        }
+    }
+
+    // Canonical codes, bit reversed for the LSB first stream
+    void buildCodes(const unsigned char* lengths, int count, unsigned short* codes)
+    {
+        int length_count[16] = {};
+        for (int i = 0; i < count; i++)
+            length_count[lengths[i]]++;
+        length_count[0] = 0;
+
+        int next[16] = {};
+        int code = 0;
+        for (int bits = 1; bits < 16; bits++)
+        {
+            code = (code + length_count[bits - 1]) << 1;
+            next[bits] = code;
+        }
+        for (int i = 0; i < count; i++)
+        {
+            const int length = lengths[i];
+            if (length == 0)
+                continue;
+            int value = next[length]++, reversed = 0;
+            for (int b = 0; b < length; b++, value >>= 1)
+                reversed = (reversed << 1) | (value & 1);
+            codes[i] = (unsigned short)reversed;
+        }
+    }
+
+    // Code lengths of the litlen and distance trees run-length coded with symbols 16, 17, 18
+    struct CodeLengthSymbol
+    {
+        unsigned char symbol;
+        unsigned char extra;
+    };
+
+    void runLengthCode(const unsigned char* lengths, int count, std::vector<CodeLengthSymbol>& out)
+    {
+        for (int i = 0; i < count;)
+        {
+            const unsigned char value = lengths[i];
+            int run = 1;
+            while (i + run < count && lengths[i + run] == value)
+                run++;
+            i += run;
+
+            if (value == 0)
+            {
+                while (run >= 11)
+                {
+                    const int take = std::min(run, 138);
+                    out.push_back({18, (unsigned char)(take - 11)});
+                    run -= take;
+                }
+                if (run >= 3)
+                {
+                    out.push_back({17, (unsigned char)(run - 3)});
+                    run = 0;
+                }
+            }
+            else
+            {
+                out.push_back({value, 0});
+                run--;
+                while (run >= 3)
+                {
+                    const int take = std::min(run, 6);
+                    out.push_back({16, (unsigned char)(take - 3)});
+                    run -= take;
+                }
+            }
+            for (; run > 0; run--)
+                out.push_back({value, 0});
+        }
+    }
+
+    void ensureTwoCodes(unsigned int* frequencies, int count)
+    {
+        int used = (int)std::count_if(frequencies, frequencies + count, [](unsigned int f) { return f > 0; });
+        for (int i = 0; used < 2 && i < count; i++)
+        {
+            if (frequencies[i] == 0)
+            {
+                frequencies[i] = 1;
+                used++;
+            }
+        }
+    }
+
+    // Writes one block of 'symbols' (which decode to raw[0, rawLength)) with whichever
+    // encoding is smallest: dynamic codes, the fixed codes or stored bytes
+    void emitBlock(BitWriter& writer, const std::vector<Symbol>& symbols, const unsigned char* raw,
+                   size_t rawLength, bool final)
+    {
+        const CodeTables& t = tables();
+        unsigned int litlen_frequency[286] = {};
+        unsigned int distance_frequency[30] = {};
+        size_t extra_bits = 0;
+        for (const Symbol& s : symbols)
+        {
+            if (s.distance == 0)
+            {
+                litlen_frequency[s.value]++;
+                continue;
+            }
+            const int length_code = t.lengthCode[s.value];
+            const int distance_code = distanceCodeOf(t, s.distance);
+            litlen_frequency[257 + length_code]++;
+            distance_frequency[distance_code]++;
+            extra_bits += kLengthExtra[length_code] + kDistanceExtra[distance_code];
+        }
+        litlen_frequency[256] = 1;
+
+        // Both trees get at least two codes so every decoder takes them as complete
+        ensureTwoCodes(litlen_frequency, 286);
+        ensureTwoCodes(distance_frequency, 30);
+
+        unsigned char litlen_lengths[286], distance_lengths[30];
+        buildLengths(litlen_frequency, 286, 15, litlen_lengths);
+        buildLengths(distance_frequency, 30, 15, distance_lengths);
+
+        int litlen_count = 286, distance_count = 30;
+        while (litlen_count > 257 && litlen_lengths[litlen_count - 1] == 0)
+            litlen_count--;
+        while (distance_count > 1 && distance_lengths[distance_count - 1] == 0)
+            distance_count--;
+
+        unsigned char all_lengths[286 + 30];
+        std::memcpy(all_lengths, litlen_lengths, litlen_count);
+        std::memcpy(all_lengths + litlen_count, distance_lengths, distance_count);
+        std::vector<CodeLengthSymbol> code_length_symbols;
+        runLengthCode(all_lengths, litlen_count + distance_count, code_length_symbols);
+
+        unsigned int code_length_frequency[19] = {};
+        for (const CodeLengthSymbol& s : code_length_symbols)
+            code_length_frequency[s.symbol]++;
+        unsigned char code_length_lengths[19];
+        buildLengths(code_length_frequency, 19, 7, code_length_lengths);
+        int code_length_count = 19;
+        while (code_length_count > 4 && code_length_lengths[kCodeLengthOrder[code_length_count - 1]] == 0)
+            code_length_count--;
+
+        // Sizes in bits of the three choices
+        size_t dynamic_bits = 3 + 14 + 3 * code_length_count + extra_bits;
+        for (const CodeLengthSymbol& s : code_length_symbols)
+            dynamic_bits += code_length_lengths[s.symbol] + (s.symbol == 16 ? 2 : s.symbol == 17 ? 3 : s.symbol == 18 ? 7 : 0);
+        size_t fixed_bits = 3 + extra_bits;
+        for (int i = 0; i < 286; i++)
+        {
+            dynamic_bits += (size_t)litlen_frequency[i] * litlen_lengths[i];
+            fixed_bits += (size_t)litlen_frequency[i] * (i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8);
+        }
+        for (int i = 0; i < 30; i++)
+        {
+            dynamic_bits += (size_t)distance_frequency[i] * distance_lengths[i];
+            fixed_bits += (size_t)distance_frequency[i] * 5;
+        }
+        // The codes added by ensureTwoCodes() are counted as if used, close enough
+        const size_t stored_bits = ((rawLength + 65534) / 65535 + (rawLength == 0)) * (3 + 7 + 32) + 8 * rawLength;
+
+        if (stored_bits < dynamic_bits && stored_bits < fixed_bits)
+        {
+            size_t offset = 0;
+            do
+            {
+                const size_t length = std::min(rawLength - offset, (size_t)65535);
+                const bool last_piece = offset + length == rawLength;
+                writer.Put(final && last_piece ? 1 : 0, 3);
+                writer.Align();
+                const unsigned char header[4] = {(unsigned char)length, (unsigned char)(length >> 8),
+                                                 (unsigned char)~length, (unsigned char)(~length >> 8)};
+                writer.PutBytes(header, 4);
+                writer.PutBytes(raw + offset, length);
+                offset += length;
+            } while (offset < rawLength);
+            return;
+        }
+
+        unsigned short litlen_codes[288] = {}, distance_codes[30] = {};
+        if (fixed_bits <= dynamic_bits)
+        {
+            unsigned char fixed_litlen[288], fixed_distance[30];
+            for (int i = 0; i < 288; i++)
+                fixed_litlen[i] = (unsigned char)(i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8);
+            std::fill(fixed_distance, fixed_distance + 30, 5);
+            std::memcpy(litlen_lengths, fixed_litlen, 286);
+            std::memcpy(distance_lengths, fixed_distance, 30);
+            buildCodes(fixed_litlen, 288, litlen_codes);
+            buildCodes(fixed_distance, 30, distance_codes);
+            writer.Put((final ? 1 : 0) | (1 << 1), 3);
+        }
+        else
+        {
+            buildCodes(litlen_lengths, 286, litlen_codes);
+            buildCodes(distance_lengths, 30, distance_codes);
+            unsigned short code_length_codes[19] = {};
+            buildCodes(code_length_lengths, 19, code_length_codes);
+
+            writer.Put((final ? 1 : 0) | (2 << 1), 3);
+            writer.Put(litlen_count - 257, 5);
+            writer.Put(distance_count - 1, 5);
+            writer.Put(code_length_count - 4, 4);
+            for (int i = 0; i < code_length_count; i++)
+                writer.Put(code_length_lengths[kCodeLengthOrder[i]], 3);
+            for (const CodeLengthSymbol& s : code_length_symbols)
+            {
+                writer.Put(code_length_codes[s.symbol], code_length_lengths[s.symbol]);
+                if (s.symbol == 16)
+                    writer.Put(s.extra, 2);
+                else if (s.symbol == 17)
+                    writer.Put(s.extra, 3);
+                else if (s.symbol == 18)
+                    writer.Put(s.extra, 7);
+            }
+        }
+
+        for (const Symbol& s : symbols)
+        {
+            if (s.distance == 0)
+            {
+                writer.Put(litlen_codes[s.value], litlen_lengths[s.value]);
+                continue;
+            }
+            const int length_code = t.lengthCode[s.value];
+            const int distance_code = distanceCodeOf(t, s.distance);
+            writer.Put(litlen_codes[257 + length_code], litlen_lengths[257 + length_code]);
+            writer.Put(s.value - kLengthBase[length_code], kLengthExtra[length_code]);
+            writer.Put(distance_codes[distance_code], distance_lengths[distance_code]);
+            writer.Put(s.distance - kDistanceBase[distance_code], kDistanceExtra[distance_code]);
+        }
+        writer.Put(litlen_codes[256], litlen_lengths[256]);
+    }
+
+    inline int matchLength(const unsigned char* a, const unsigned char* b, int limit)
+    {
+        int length = 0;
+        while (length + 8 <= limit)
+        {
+            unsigned long long x, y;
+            std::memcpy(&x, a + length, 8);
+            std::memcpy(&y, b + length, 8);
+            if (x != y)
+                return length + (__builtin_ctzll(x ^ y) >> 3);
+            length += 8;
+        }
+        while (length < limit && a[length] == b[length])
+            length++;
+        return length;
+    }
+
+    // LZ77 over one strip with a hash chained 32 KB window
+    class Matcher
+    {
+        private:
+            const unsigned char* m_Data;
+            size_t m_Base, m_End;       // positions are stored relative to m_Base
+            LevelParams m_Params;
+            std::vector<int> m_Head;
+            std::vector<int> m_Previous;
+        public:
+            Matcher(const unsigned char* data, size_t base, size_t end, const LevelParams& params)
+                : m_Data(data), m_Base(base), m_End(end), m_Params(params),
+                  m_Head(1 << kHashBits, -1), m_Previous(kWindow, -1) {}
+
+            inline unsigned int Hash(size_t position) const
+            {
+                const unsigned char* p = m_Data + position;
+                const unsigned int bytes = p[0] | (p[1] << 8) | (p[2] << 16);
+                return (bytes * 0x9E3779B1u) >> (32 - kHashBits);
+            }
+
+            // Positions closer than kMinMatch to the end are never inserted
+            inline void Insert(size_t position)
+            {
+                if (position + kMinMatch > m_End)
+                    return;
+                const unsigned int hash = Hash(position);
+                const int relative = (int)(position - m_Base);
+                m_Previous[relative & (kWindow - 1)] = m_Head[hash];
+                m_Head[hash] = relative;
+            }
+
+            // Longest match for 'position' among earlier positions, 0 when under kMinMatch
+            int Find(size_t position, int chain, int& distance) const
+            {
+                const int limit = (int)std::min((size_t)kMaxMatch, m_End - position);
+                if (limit < kMinMatch)
+                    return 0;
+                const unsigned char* current = m_Data + position;
+                const int relative = (int)(position - m_Base);
+                int best = kMinMatch - 1;
+                int candidate = m_Head[Hash(position)];
+                for (; candidate >= 0 && chain > 0; chain--)
+                {
+                    const int gap = relative - candidate;
+                    if (gap <= 0 || gap > kWindow)
+                        break;
+                    const unsigned char* earlier = current - gap;
+                    if (earlier[best] == current[best] && earlier[0] == current[0])
+                    {
+                        const int length = matchLength(earlier, current, limit);
+                        if (length > best)
+                        {
+                            best = length;
+                            distance = gap;
+                            if (length >= m_Params.nice || length == limit)
+                                break;
+                        }
+                    }
+                    const int next = m_Previous[candidate & (kWindow - 1)];
+                    // A slot reused by a newer position ends the chain
+                    if (next >= candidate)
+                        break;
+                    candidate = next;
+                }
+                return best >= kMinMatch ? best : 0;
+            }
+    };
+}
+
+void deflateStrip(const unsigned char* data, size_t begin, size_t end, int level, bool last,
+                  std::vector<unsigned char>& out)
+{
+    BitWriter writer(out);
+    level = std::min(std::max(level, 0), 9);
+
+    if (level == 0)
+    {
+        // Stored blocks end byte aligned, no empty block needed between strips
+        if (begin == end && !last)
+            return;
+        size_t offset = begin;
+        do
+        {
+            const size_t length = std::min(end - offset, (size_t)65535);
+            writer.Put(last && offset + length == end ? 1 : 0, 3);
+            writer.Align();
+            const unsigned char header[4] = {(unsigned char)length, (unsigned char)(length >> 8),
+                                             (unsigned char)~length, (unsigned char)(~length >> 8)};
+            writer.PutBytes(header, 4);
+            writer.PutBytes(data + offset, length);
+            offset += length;
+        } while (offset < end);
+        return;
+    }
+    if (begin == end && !last)
+        return;
+
+    const LevelParams& params = kLevels[level];
+    const size_t base = begin > (size_t)kWindow ? begin - kWindow : 0;
+    Matcher matcher(data, base, end, params);
+    for (size_t p = base; p < begin; p++)
+        matcher.Insert(p);
+
+    std::vector<Symbol> symbols;
+    symbols.reserve(std::min(kBlockSymbols, end - begin) + 1);
+    size_t block_start = begin;
+    size_t p = begin;
+    bool carried = false;
+    int carried_length = 0, carried_distance = 0;
+
+    while (p < end)
+    {
+        if (symbols.size() >= kBlockSymbols)
+        {
+            emitBlock(writer, symbols, data + block_start, p - block_start, false);
+            symbols.clear();
+            block_start = p;
+        }
+
+        int length, distance = 0;
+        if (carried)
+        {
+            length = carried_length;
+            distance = carried_distance;
+            carried = false;
+        }
+        else
+        {
+            length = matcher.Find(p, params.chain, distance);
+        }
+        matcher.Insert(p);
+
+        if (length == 0)
+        {
+            symbols.push_back({data[p], 0});
+            p++;
+            continue;
+        }
+
+        // Lazy matching: a longer match one byte on wins over this one
+        if (length < params.lazy)
+        {
+            int next_distance = 0;
+            const int chain = length >= params.good ? params.chain >> 2 : params.chain;
+            const int next_length = matcher.Find(p + 1, chain, next_distance);
+            if (next_length > length)
+            {
+                symbols.push_back({data[p], 0});
+                p++;
+                carried = true;
+                carried_length = next_length;
+                carried_distance = next_distance;
+                continue;
+            }
+        }
+
+        symbols.push_back({(unsigned short)length, (unsigned short)distance});
+        for (size_t q = p + 1; q < p + length; q++)
+            matcher.Insert(q);
+        p += length;
+    }
+    emitBlock(writer, symbols, data + block_start, end - block_start, last);
+
+    if (!last)
+    {
+        // Empty stored block: byte aligns the stream without ending it
+        writer.Put(0, 3);
+        writer.Align();
+        const unsigned char header[4] = {0, 0, 0xFF, 0xFF};
+        writer.PutBytes(header, 4);
+    }
+    else
+    {
+        writer.Align();
+    }
+}
+
+unsigned int adler32(const unsigned char* data, size_t length, unsigned int adler)
+{
+    const unsigned int kBase = 65521;
+    // Largest n with 255 n (n + 1) / 2 + (n + 1) (kBase - 1) < 2^32
+    const size_t kChunk = 5552;
+    unsigned int a = adler & 0xFFFF, b = adler >> 16;
+    while (length > 0)
+    {
+        const size_t n = std::min(length, kChunk);
+        for (size_t i = 0; i < n; i++)
+        {
+            a += data[i];
+            b += a;
+        }
+        a %= kBase;
+        b %= kBase;
+        data += n;
+        length -= n;
+    }
+    return a | (b << 16);
+}
+
+unsigned int adler32Combine(unsigned int first, unsigned int second, size_t secondLength)
+{
+    // zlib's adler32_combine()
+    const unsigned long long kBase = 65521;
+    const unsigned long long remainder = secondLength % kBase;
+    unsigned long long sum1 = first & 0xFFFF;
+    unsigned long long sum2 = (remainder * sum1) % kBase;
+    sum1 += (second & 0xFFFF) + kBase - 1;
+    sum2 += ((first >> 16) & 0xFFFF) + ((second >> 16) & 0xFFFF) + kBase - remainder;
+    if (sum1 >= kBase) sum1 -= kBase;
+    if (sum1 >= kBase) sum1 -= kBase;
+    if (sum2 >= (kBase << 1)) sum2 -= (kBase << 1);
+    if (sum2 >= kBase) sum2 -= kBase;
+    return (unsigned int)(sum1 | (sum2 << 16));
+}
+
+unsigned int crc32(const unsigned char* data, size_t length, unsigned int crc)
+{
+    const CodeTables& t = tables();
+    unsigned int c = ~crc;
+    for (; length >= 4; length -= 4, data += 4)
+    {
+        c ^= data[0] | (data[1] << 8) | (data[2] << 16) | ((unsigned int)data[3] << 24);
+        c = t.crc[3][c & 0xFF] ^ t.crc[2][(c >> 8) & 0xFF] ^ t.crc[1][(c >> 16) & 0xFF] ^ t.crc[0][c >> 24];
+    }
+    for (; length > 0; length--, data++)
+        c = t.crc[0][(c ^ *data) & 0xFF] ^ (c >> 8);
+    return ~c;
+}
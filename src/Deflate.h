@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Raw deflate (RFC 1951) of data[begin, end), appended to 'out'.
+//   level 0     stored blocks, no compression
+//   level 1..9  LZ77 with longer hash chains (and lazy matching from 4 on) as the level
+//               goes up; every block is sent with dynamic, fixed or no Huffman codes,
+//               whichever is smallest
+// Matches may reach back into the 32 KB before 'begin', so independent pieces of one
+// buffer deflated in parallel still see their predecessor's data (as in pigz). Unless
+// 'last' is set, the output ends with an empty stored block: it is byte aligned and not
+// final, and the pieces join into one valid stream by plain concatenation.
+void deflateStrip(const unsigned char* data, size_t begin, size_t end, int level, bool last,
+                  std::vector<unsigned char>& out);
+
+// Checksums of zlib (adler32) and PNG chunks (crc32). Pass the previous result to
+// continue over more data.
+unsigned int adler32(const unsigned char* data, size_t length, unsigned int adler = 1);
+unsigned int crc32(const unsigned char* data, size_t length, unsigned int crc = 0);
+
+// adler32 of A followed by B, from adler32(A), adler32(B) and B's length
+unsigned int adler32Combine(unsigned int first, unsigned int second, size_t secondLength);
@@ -0,0 +1,50 @@
+#include <Dither.h>
+
+void errorDiffusionDither(DiffusionKernel kernel,
+                          const unsigned char* src, int width, int height, int srcStride,
+                          unsigned char* dst, int dstStride,
+                          const DitherOptions& options, ThreadPool& pool)
+{
+    switch (kernel)
+    {
+        case DiffusionKernel::FloydSteinberg:
+            errorDiffusionDither<FloydSteinbergKernel>(src, width, height, srcStride, dst, dstStride, options, pool);
+            break;
+        case DiffusionKernel::JarvisJudiceNinke:
+            errorDiffusionDither<JarvisJudiceNinkeKernel>(src, width, height, srcStride, dst, dstStride, options, pool);
+            break;
+        case DiffusionKernel::Stucki:
+            errorDiffusionDither<StuckiKernel>(src, width, height, srcStride, dst, dstStride, options, pool);
+            break;
+        case DiffusionKernel::Atkinson:
+            errorDiffusionDither<AtkinsonKernel>(src, width, height, srcStride, dst, dstStride, options, pool);
+            break;
+        case DiffusionKernel::Sierra:
+            errorDiffusionDither<SierraKernel>(src, width, height, srcStride, dst, dstStride, options, pool);
+            break;
+    }
+}
+
+void floydSteinbergDither(const unsigned char* src, int width, int height, int srcStride,
+                          unsigned char* dst, int dstStride,
+                          const DitherOptions& options, ThreadPool& pool)
+{
+    errorDiffusionDither<FloydSteinbergKernel, 16>(src, width, height, srcStride, dst, dstStride, options, pool);
+}
+
+std::unique_ptr<DitherStream> createDitherStream(DiffusionKernel kernel, int width, bool serpentine)
+{
+    switch (kernel)
+    {
+        case DiffusionKernel::JarvisJudiceNinke:
+            return std::unique_ptr<DitherStream>(new ErrorDiffuser<JarvisJudiceNinkeKernel>(width, serpentine));
+        case DiffusionKernel::Stucki:
+            return std::unique_ptr<DitherStream>(new ErrorDiffuser<StuckiKernel>(width, serpentine));
+        case DiffusionKernel::Atkinson:
+            return std::unique_ptr<DitherStream>(new ErrorDiffuser<AtkinsonKernel>(width, serpentine));
+        case DiffusionKernel::Sierra:
+            return std::unique_ptr<DitherStream>(new ErrorDiffuser<SierraKernel>(width, serpentine));
+        default:
+            return std::unique_ptr<DitherStream>(new ErrorDiffuser<FloydSteinbergKernel>(width, serpentine));
+    }
+}
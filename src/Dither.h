@@ -0,0 +1,337 @@
+#pragma once
+
+#include <ThreadPool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+struct DitherOptions
+{
+    // Odd rows run right to left with the kernel mirrored, which breaks up the
+    // diagonal "worm" artifacts of a plain raster scan
+    bool serpentine = false;
+
+    // Row r + 1 trails row r by a few pixels on another thread. Output is identical
+    // to the serial scan. A serpentine row needs the whole row above first, so with
+    // 'serpentine' set this falls back to the serial scan.
+    bool wavefront = false;
+};
+
+// Diffusion kernels: kWeights[0] is the current row, whose taps left of (and at) the
+// pixel are always 0, the others are the rows below. Columns run from -kRadius to
+// +kRadius. Weights are out of kDivisor, Atkinson only passes on 6/8 of the error.
+struct FloydSteinbergKernel
+{
+    static constexpr int kRows = 2, kRadius = 1, kDivisor = 16;
+    static constexpr int kWeights[kRows][2 * kRadius + 1] = {{0, 0, 7},
+                                                              {3, 5, 1}};
+};
+
+struct JarvisJudiceNinkeKernel
+{
+    static constexpr int kRows = 3, kRadius = 2, kDivisor = 48;
+    static constexpr int kWeights[kRows][2 * kRadius + 1] = {{0, 0, 0, 7, 5},
+                                                              {3, 5, 7, 5, 3},
+                                                              {1, 3, 5, 3, 1}};
+};
+
+struct StuckiKernel
+{
+    static constexpr int kRows = 3, kRadius = 2, kDivisor = 42;
+    static constexpr int kWeights[kRows][2 * kRadius + 1] = {{0, 0, 0, 8, 4},
+                                                              {2, 4, 8, 4, 2},
+                                                              {1, 2, 4, 2, 1}};
+};
+
+struct AtkinsonKernel
+{
+    static constexpr int kRows = 3, kRadius = 2, kDivisor = 8;
+    static constexpr int kWeights[kRows][2 * kRadius + 1] = {{0, 0, 0, 1, 1},
+                                                              {0, 1, 1, 1, 0},
+                                                              {0, 0, 1, 0, 0}};
+};
+
+struct SierraKernel
+{
+    static constexpr int kRows = 3, kRadius = 2, kDivisor = 32;
+    static constexpr int kWeights[kRows][2 * kRadius + 1] = {{0, 0, 0, 5, 3},
+                                                              {2, 4, 5, 4, 2},
+                                                              {0, 2, 3, 2, 0}};
+};
+
+enum class DiffusionKernel
+{
+    FloydSteinberg, JarvisJudiceNinke, Stucki, Atkinson, Sierra
+};
+
+// Error diffusion to 'Levels' evenly spaced grey levels in fixed point. Errors are kept
+// in 1/16 pixel and only Kernel::kRows rows of them are live, so memory does not grow
+// with the image height. The kernel's taps and divisor are compile-time constants: the
+// tap loops unroll, zero taps vanish and the divide becomes a shift (power of two
+// divisors) or a multiply-shift. Errors leaving the image are dropped.
+// Strides are in bytes, 0 means tightly packed. 'dst' may alias 'src' when both use
+// the same stride.
+template <class Kernel, int Levels = 16>
+void errorDiffusionDither(const unsigned char* src, int width, int height, int srcStride,
+                          unsigned char* dst, int dstStride,
+                          const DitherOptions& options = DitherOptions(),
+                          ThreadPool& pool = ThreadPool::Global());
+
+// Run-time kernel choice over the 16 level instances
+void errorDiffusionDither(DiffusionKernel kernel,
+                          const unsigned char* src, int width, int height, int srcStride,
+                          unsigned char* dst, int dstStride,
+                          const DitherOptions& options = DitherOptions(),
+                          ThreadPool& pool = ThreadPool::Global());
+
+// errorDiffusionDither<FloydSteinbergKernel, 16>
+void floydSteinbergDither(const unsigned char* src, int width, int height, int srcStride,
+                          unsigned char* dst, int dstStride,
+                          const DitherOptions& options = DitherOptions(),
+                          ThreadPool& pool = ThreadPool::Global());
+
+namespace dither_detail
+{
+    const int kFraction = 4;            // pixel values and errors carry 4 fraction bits
+    const int kOne = 1 << kFraction;
+
+    // Pixels handed to the next row at once in wavefront mode, at least 2 * kRadius (see
+    // ditherWavefront())
+    const int kWavefrontChunk = 64;
+
+    // round(x / Divisor) without a divide, exact for |x| < Divisor * 2^20
+    template <int Divisor>
+    inline int roundedDivide(int x)
+    {
+        if constexpr ((Divisor & (Divisor - 1)) == 0)
+        {
+            constexpr int shift = __builtin_ctz(Divisor);
+            return (x + Divisor / 2) >> shift;
+        }
+        else
+        {
+            // Biased to stay positive, so the reciprocal multiply rounds down for both signs
+            constexpr long long bias = (long long)Divisor << 20;
+            constexpr unsigned long long reciprocal = ((1ull << 36) + Divisor - 1) / Divisor;
+            return (int)((((unsigned long long)(x + Divisor / 2 + bias)) * reciprocal) >> 36) - (1 << 20);
+        }
+    }
+
+    // 'value' in 1/16 pixel -> nearest level, 'error' is what is left in 1/16 pixel
+    template <int Levels>
+    inline unsigned char quantize(int value, int& error)
+    {
+        static_assert(Levels >= 2 && Levels <= 256, "Levels must be 2..256");
+        int level = value <= 0 ? 0 : (value * (Levels - 1) + 255 * kOne / 2) / (255 * kOne);
+        level = std::min(level, Levels - 1);
+        const int out = (level * 255 + (Levels - 1) / 2) / (Levels - 1);
+        error = value - (out << kFraction);
+        return (unsigned char)out;
+    }
+
+    // Pixels 'begin' up to (not including) 'end', stepping by 'step' (+1 or -1, the kernel
+    // is mirrored with it). rows[k] is the error row k below the current one; they hold
+    // error * weight and are padded by kRadius entries on each side. Error going further
+    // along the current row stays in 'carry' (carry[j] is for pixel x + (j + 1) * step).
+    template <class Kernel, int Levels>
+    void diffuseSpan(const unsigned char* src, unsigned char* dst, int* const* rows,
+                     int begin, int end, int step, int (&carry)[Kernel::kRadius])
+    {
+        constexpr int R = Kernel::kRadius;
+        int pending[R];
+        int* below[Kernel::kRows];
+        for (int j = 0; j < R; j++)
+            pending[j] = carry[j];
+        for (int k = 0; k < Kernel::kRows; k++)
+            below[k] = rows[k];
+
+        for (int x = begin; x != end; x += step)
+        {
+            const int value = (src[x] << kFraction) + roundedDivide<Kernel::kDivisor>(below[0][x] + pending[0]);
+            int error;
+            dst[x] = quantize<Levels>(value, error);
+
+            for (int j = 0; j < R - 1; j++)
+                pending[j] = pending[j + 1] + error * Kernel::kWeights[0][R + 1 + j];
+            pending[R - 1] = error * Kernel::kWeights[0][2 * R];
+
+            for (int k = 1; k < Kernel::kRows; k++)
+            {
+                for (int t = -R; t <= R; t++)
+                {
+                    const int weight = Kernel::kWeights[k][t + R];
+                    if (weight != 0)
+                        below[k][x + t * step] += error * weight;
+                }
+            }
+        }
+
+        for (int j = 0; j < R; j++)
+            carry[j] = pending[j];
+    }
+
+}
+
+// Serial scan that keeps its error rows between calls, for images that arrive a strip
+// at a time. Feeding a frame in any number of pieces gives the same output as one
+// errorDiffusionDither() call with the wavefront off.
+class DitherStream
+{
+    public:
+        virtual ~DitherStream() {}
+
+        // Dithers the next 'rows' rows of the frame. Strides as for errorDiffusionDither().
+        virtual void Process(const unsigned char* src, int rows, int srcStride, unsigned char* dst, int dstStride) = 0;
+};
+
+template <class Kernel, int Levels = 16>
+class ErrorDiffuser : public DitherStream
+{
+    private:
+        int m_Width;
+        bool m_Serpentine;
+        int m_Row;      // rows done so far, picks the direction of serpentine rows
+        std::vector<int> m_Buffer;
+        int* m_Rows[Kernel::kRows];
+    public:
+        ErrorDiffuser(int width, bool serpentine = false)
+            : m_Width(width), m_Serpentine(serpentine), m_Row(0),
+              m_Buffer((size_t)Kernel::kRows * (width + 2 * Kernel::kRadius), 0)
+        {
+            for (int k = 0; k < Kernel::kRows; k++)
+                m_Rows[k] = m_Buffer.data() + (size_t)k * (width + 2 * Kernel::kRadius) + Kernel::kRadius;
+        }
+
+        ErrorDiffuser(const ErrorDiffuser&) = delete;
+        ErrorDiffuser& operator=(const ErrorDiffuser&) = delete;
+
+        void Process(const unsigned char* src, int rows, int srcStride, unsigned char* dst, int dstStride) override
+        {
+            const int width = m_Width;
+            if (srcStride == 0)
+                srcStride = width;
+            if (dstStride == 0)
+                dstStride = width;
+
+            for (int y = 0; y < rows; y++, m_Row++)
+            {
+                const unsigned char* s = src + (size_t)y * srcStride;
+                unsigned char* d = dst + (size_t)y * dstStride;
+                int carry[Kernel::kRadius] = {};
+                if (m_Serpentine && (m_Row & 1))
+                    dither_detail::diffuseSpan<Kernel, Levels>(s, d, m_Rows, width - 1, -1, -1, carry);
+                else
+                    dither_detail::diffuseSpan<Kernel, Levels>(s, d, m_Rows, 0, width, 1, carry);
+
+                // The finished row comes back cleared as the lowest one
+                int* done = m_Rows[0];
+                std::fill(done - Kernel::kRadius, done + width + Kernel::kRadius, 0);
+                for (int k = 1; k < Kernel::kRows; k++)
+                    m_Rows[k - 1] = m_Rows[k];
+                m_Rows[Kernel::kRows - 1] = done;
+            }
+        }
+
+        inline int GetWidth() const { return m_Width; }
+};
+
+// ErrorDiffuser of a run-time kernel choice (16 levels)
+std::unique_ptr<DitherStream> createDitherStream(DiffusionKernel kernel, int width, bool serpentine = false);
+
+namespace dither_detail
+{
+    template <class Kernel, int Levels>
+    void ditherSerial(const unsigned char* src, int width, int height, int srcStride,
+                      unsigned char* dst, int dstStride, bool serpentine)
+    {
+        ErrorDiffuser<Kernel, Levels> diffuser(width, serpentine);
+        diffuser.Process(src, height, srcStride, dst, dstStride);
+    }
+
+    // Rows are claimed in order by whichever thread is free. Row r may run pixel x once
+    // row r - 1 is done with x + kRadius: every row above diffuses at most kRadius columns
+    // sideways, and row r - 1 can't be past a pixel its own upper rows haven't reached.
+    // Unfinished rows are always the newest few (a row can't end before the one above it),
+    // so a ring of threads + kRows error rows and progress counters is never overrun.
+    // With 3 row kernels rows r - 1 and r both add into row r + 1. Progress goes out a
+    // whole chunk at a time, so row r - 1 is then working at least a chunk past the end of
+    // row r's span, and their writes stay apart only while a chunk is >= 2 * kRadius
+    // columns. Per pixel progress would let them race.
+    template <class Kernel, int Levels>
+    void ditherWavefront(const unsigned char* src, int width, int height, int srcStride,
+                         unsigned char* dst, int dstStride, ThreadPool& pool)
+    {
+        static_assert(kWavefrontChunk >= 2 * Kernel::kRadius,
+                      "wavefront chunks must be at least 2 * kRadius wide or neighbouring rows race on the row below");
+        const int threads = (int)pool.GetThreadCount();
+        const int ring = threads + Kernel::kRows;
+        const int padded = width + 2 * Kernel::kRadius;
+        std::vector<int> buffer((size_t)ring * padded, 0);
+
+        // Progress of a row is published as row * (width + 1) + pixels done. Values only
+        // grow, so a slot already taken over by a later row still reads as "done".
+        const long long stride = width + 1;
+        std::unique_ptr<std::atomic<long long>[]> progress(new std::atomic<long long>[ring]);
+        for (int i = 0; i < ring; i++)
+            progress[i].store(-1, std::memory_order_relaxed);
+        std::atomic<int> next_row{0};
+
+        pool.ParallelFor(threads, [&](int)
+        {
+            int y;
+            while ((y = next_row.fetch_add(1)) < height)
+            {
+                int* rows[Kernel::kRows];
+                for (int k = 0; k < Kernel::kRows; k++)
+                    rows[k] = buffer.data() + (size_t)((y + k) % ring) * padded + Kernel::kRadius;
+
+                // The lowest row is new to this pass, everyone who used its slot is finished
+                int* lowest = rows[Kernel::kRows - 1];
+                if (y > 0)
+                    std::fill(lowest - Kernel::kRadius, lowest + width + Kernel::kRadius, 0);
+
+                const unsigned char* s = src + (size_t)y * srcStride;
+                unsigned char* d = dst + (size_t)y * dstStride;
+                std::atomic<long long>& above = progress[(y + ring - 1) % ring];
+                std::atomic<long long>& mine = progress[y % ring];
+                const long long above_start = (long long)(y - 1) * stride;
+                long long seen = y == 0 ? above_start + width : above.load(std::memory_order_acquire);
+
+                int carry[Kernel::kRadius] = {};
+                for (int x = 0; x < width; x += kWavefrontChunk)
+                {
+                    const int end = std::min(width, x + kWavefrontChunk);
+                    const long long needed = above_start + std::min(width, end + Kernel::kRadius);
+                    while (seen < needed)
+                    {
+                        std::this_thread::yield();
+                        seen = above.load(std::memory_order_acquire);
+                    }
+                    diffuseSpan<Kernel, Levels>(s, d, rows, x, end, 1, carry);
+                    mine.store((long long)y * stride + end, std::memory_order_release);
+                }
+            }
+        });
+    }
+}
+
+template <class Kernel, int Levels>
+void errorDiffusionDither(const unsigned char* src, int width, int height, int srcStride,
+                          unsigned char* dst, int dstStride,
+                          const DitherOptions& options, ThreadPool& pool)
+{
+    if (width <= 0 || height <= 0)
+        return;
+    if (srcStride == 0)
+        srcStride = width;
+    if (dstStride == 0)
+        dstStride = width;
+
+    if (options.wavefront && !options.serpentine && height > 1 && pool.GetThreadCount() > 1)
+        dither_detail::ditherWavefront<Kernel, Levels>(src, width, height, srcStride, dst, dstStride, pool);
+    else
+        dither_detail::ditherSerial<Kernel, Levels>(src, width, height, srcStride, dst, dstStride, options.serpentine);
+}
@@ -0,0 +1,264 @@
+#include <Filters.h>
+#include <ColorConvert.h>
+#include <Dither.h>
+#include <GaussianBlur.h>
+#include <Resample.h>
+
+#include <cmath>
+#include <cstring>
+using namespace std;
+
+
+extern const float ker[3][3] = {
+        {1.0 / 16, 2.0 / 16, 1.0 / 16},
+        {2.0 / 16, 4.0 / 16, 2.0 / 16},
+        {1.0 / 16, 2.0 / 16, 1.0 / 16}};
+
+extern  const int GaussX[3][3] = {
+        {-1, 0, 1},
+        {-2, 0, 2},
+        {-1, 0, 1}};
+
+extern const int GaussY[3][3] = {
+        {-1, -2, -1},
+        {0, 0, 0},
+        {1, 2, 1}};
+
+
+
+
+void copy_image(unsigned char* image, const vector<unsigned char>& new_image, int length){
+    for (int i = 0; i < length; i++)
+    {
+        image[i] = new_image[i];
+    }
+}
+
+
+void noise(ConstImageView src, ImageView dst){
+    const int width = src.GetWidth(), height = src.GetHeight();
+
+    // fixed-point separable form of ker (bit-exact, see GaussianBlur.h)
+    for (int i = 1; i < height - 1; i++){
+        gaussianRow3x3(src.GetRow(i - 1), src.GetRow(i), src.GetRow(i + 1), dst.GetRow(i), width);
+    }
+    for (int i = 0; i < height; i++){// left and right edge
+        dst.GetRow(i)[0] = src.GetRow(i)[0];
+        dst.GetRow(i)[width - 1] = src.GetRow(i)[width - 1];
+    }
+    for (int i = 0; i < width; i++){ // up and beneath edge
+        dst.GetRow(0)[i] = src.GetRow(0)[i];
+        dst.GetRow(height - 1)[i] = src.GetRow(height - 1)[i];
+    }
+}
+
+void noise(unsigned char *image, int width, int height, int length){
+    Image new_image(width, height, 1);
+    noise(ConstImageView(image, width, height), new_image.View());
+
+    // copy new image
+    copyPixels(new_image.View(), ImageView(image, width, height));
+}
+
+
+void gradientCalculation(ConstImageView src, ImageView magnitude, ImageView directions, GradientNorm norm)
+{
+    const int width = src.GetWidth(), height = src.GetHeight();
+
+    // GaussX / GaussY with integer direction binning (see Sobel.h), the frame border stays 0
+    for (int i = 1; i < height - 1; i++){
+        sobelRow(src.GetRow(i - 1), src.GetRow(i), src.GetRow(i + 1),
+                 magnitude.GetRow(i), directions.GetRow(i), width, norm);
+        magnitude.GetRow(i)[0] = magnitude.GetRow(i)[width - 1] = 0;
+        directions.GetRow(i)[0] = directions.GetRow(i)[width - 1] = 0;
+    }
+    for (int i = 0; i < height; i += max(1, height - 1)){
+        std::memset(magnitude.GetRow(i), 0, width);
+        std::memset(directions.GetRow(i), 0, width);
+    }
+}
+
+vector<unsigned char> gradientCalculation(unsigned char *image, int width, int height, int length, GradientNorm norm)
+{
+    Image new_image(width, height, 1);
+    vector<unsigned char> directions(length); // EdgeDirection per pixel
+    gradientCalculation(ConstImageView(image, width, height), new_image.View(),
+                        ImageView(directions.data(), width, height), norm);
+
+    // copy new image
+    copyPixels(new_image.View(), ImageView(image, width, height));
+
+    return directions;
+}
+
+void Non_MaxSuppression(ConstImageView src, ConstImageView directions, ImageView dst){
+    const int width = src.GetWidth(), height = src.GetHeight();
+    unsigned char pixel;
+    unsigned char neighbor1, neighbor2;
+
+    for (int i = 0; i < height; i += max(1, height - 1)){ // border stays 0
+        std::memset(dst.GetRow(i), 0, width);
+    }
+    for (int i = 1; i < height - 1; i++){
+        const unsigned char* up = src.GetRow(i - 1);
+        const unsigned char* row = src.GetRow(i);
+        const unsigned char* down = src.GetRow(i + 1);
+        const unsigned char* direction = directions.GetRow(i);
+        unsigned char* out = dst.GetRow(i);
+        out[0] = out[width - 1] = 0;
+
+        for (int j = 1; j < width - 1; j++){
+            pixel = row[j];
+
+            switch (direction[j]){
+                case EDGE_DIR_0: //(i,j+1),(i,j-1)
+                    neighbor1 = row[j + 1];
+                    neighbor2 = row[j - 1];
+                    break;
+                case EDGE_DIR_90: //(i+1,j),(i-1,j)
+                    neighbor1 = down[j];
+                    neighbor2 = up[j];
+                    break;
+                case EDGE_DIR_135: //(i+1,j-1),(i-1,j+1)
+                    neighbor1 = down[j - 1];
+                    neighbor2 = up[j + 1];
+                    break;
+                default: //(i+1,j+1),(i-1,j-1)
+                    neighbor1 = down[j + 1];
+                    neighbor2 = up[j - 1];
+                    break;
+            }
+
+            out[j] = (neighbor1 <= pixel && neighbor2 <= pixel) ? pixel : 0;
+        }
+    }
+}
+
+void Non_MaxSuppression(unsigned char *image, int width, int height, int length, const vector<unsigned char>& directions){
+    Image new_image(width, height, 1);
+    Non_MaxSuppression(ConstImageView(image, width, height), ConstImageView(directions.data(), width, height),
+                       new_image.View());
+
+    // copy new image
+    copyPixels(new_image.View(), ImageView(image, width, height));
+}
+
+unsigned char findArea(unsigned char pixel_value){
+    int val= std::sqrt(255 * 255 *1.75);
+    int low = val *0.5;
+    int high =val *0.3;
+    if (pixel_value <= low){ // non-relevant edge
+        return 0;
+    }
+    if (pixel_value <= high && pixel_value > low){ // weak edge
+        return 1;
+    }
+    return 255;// the rest (strong edge)
+}
+
+void Thresholding(ImageView image){
+    for (int i = 0; i < image.GetHeight(); i++){
+        unsigned char* row = image.GetRow(i);
+        for (int j = 0; j < image.GetWidth(); j++){
+            row[j] = findArea(row[j]);
+        }
+    }
+}
+
+void Thresholding(unsigned char *img, int width, int height){
+    Thresholding(ImageView(img, width, height));
+}
+
+void Hysteresis(ConstImageView src, ImageView dst){
+    const int width = src.GetWidth(), height = src.GetHeight();
+    unsigned char pixel_value;
+    bool check_weak = false;    //efficient
+
+    for (int i = 0; i < height; i += max(1, height - 1)){ // border stays 0
+        std::memset(dst.GetRow(i), 0, width);
+    }
+    for (int i = 1; i < height - 1; i++){
+        unsigned char* out = dst.GetRow(i);
+        out[0] = out[width - 1] = 0;
+        for (int j = 1; j < width - 1; j++){
+            pixel_value = src.GetRow(i)[j];
+            out[j] = 0;
+            if (pixel_value == 1){ // weak edge
+                for (int n = 0; (!check_weak) & (n < 3); n++){
+                    for (int m = 0; (!check_weak) & (m < 3); m++){
+
+                        if (src.GetRow(i + n - 1)[j + m - 1] == 255){
+                            out[j] = 255;
+                            check_weak = true; // break loop
+                        }
+                    }
+                }
+            }
+            else if (pixel_value == 255) {  // strong edge
+                out[j] = 255;
+            }
+
+            check_weak = false; //reset
+        }
+    }
+}
+
+void Hysteresis(unsigned char *image, int width, int height, int length){
+    Image new_image(width, height, 1);
+    Hysteresis(ConstImageView(image, width, height), new_image.View());
+
+    // copy new image
+    copyPixels(new_image.View(), ImageView(image, width, height));
+}
+
+
+void update_pixel(unsigned char* image,int width, int col,int row ,int a,int b,int c,int d){
+            image[row * 2 * 2 * width + col * 2] = a;
+            image[row * 2 * 2 * width + col * 2 + 1] = b;
+            image[(row * 2 + 1) * 2 * width + col * 2] = c;
+            image[(row * 2 + 1) * 2 * width + col * 2 + 1] = d;
+}
+
+//  Halftone
+unsigned char * haftone(unsigned char * image, int width, int height) {
+    int length = width * height;
+    unsigned char * new_image = new unsigned char[length * 4];
+    for (int i = 0; i < length; i++) {
+        int row = i / width;
+        int col = i % width;
+        if (image[i] >= 255.0 / 5 * 4) 
+            { update_pixel(new_image,width,col,row,255,255,255,255); }
+        else if (image[i] >= 255.0 / 5 && image[i] < 255.0 / 5 * 2 ) 
+            { update_pixel(new_image,width,col,row,0,0,255,0);    } 
+        else if (image[i] >= 255.0 / 5 * 2 && image[i] < 255.0 / 5 * 3) 
+            { update_pixel(new_image,width,col,row,255,0,255,0); } 
+        else if (image[i] >= 255.0 / 5 * 3 && image[i] < 255.0 / 5 * 4) 
+            { update_pixel(new_image,width,col,row,0,255,255,255); } 
+        else if (image[i] < 255.0 / 5) 
+            { update_pixel(new_image,width,col,row,0,0,0,0); }
+    }
+    return new_image;
+}
+
+//compressing image to smaller size
+void compressImage(const unsigned char* old_Image, unsigned char* new_Image) {
+    areaResample(old_Image, 512, 512, 0, new_Image, 256, 256, 0);
+}
+
+
+
+unsigned char* floydSteinbergTo16Grayscale(const unsigned char* image, int width, int height) {
+    unsigned char* output_image = new unsigned char[width * height];
+    floydSteinbergDither(image, width, height, 0, output_image, 0);
+    return output_image;
+}
+
+
+
+
+unsigned char * Grayscale(unsigned char * image, int length) {
+    unsigned char * new_image = new unsigned char[length];
+    lumaRow(image, PixelFormat::RGBA, new_image, length); // fixed-point 0.2989 / 0.5870 / 0.1140, see ColorConvert.h
+    return new_image;
+}
+
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <Image.h>
+#include <Sobel.h>
+
+#include <vector>
+
+/* Convolution kernels shared by the full-frame filters and the Canny engine */
+extern const float ker[3][3];
+extern const int GaussX[3][3];
+extern const int GaussY[3][3];
+
+void copy_image(unsigned char* image, const std::vector<unsigned char>& new_image, int length);
+
+// Canny stages on views: read 'src', write every pixel of 'dst' (same size, must not alias).
+// Ping-ponging two buffers through them needs no copies. The frame border comes out as
+// 0 except for noise(), which keeps the source border.
+void noise(ConstImageView src, ImageView dst);
+void gradientCalculation(ConstImageView src, ImageView magnitude, ImageView directions, GradientNorm norm = GradientNorm::L2);
+void Non_MaxSuppression(ConstImageView src, ConstImageView directions, ImageView dst);
+void Thresholding(ImageView image);
+void Hysteresis(ConstImageView src, ImageView dst);
+
+// Canny stages (full frame, in place)
+void noise(unsigned char *image, int width, int height, int length);
+std::vector<unsigned char> gradientCalculation(unsigned char *image, int width, int height, int length, GradientNorm norm = GradientNorm::L2);
+void Non_MaxSuppression(unsigned char *image, int width, int height, int length, const std::vector<unsigned char>& directions);
+unsigned char findArea(unsigned char pixel_value);
+void Thresholding(unsigned char *img, int width, int height);
+void Hysteresis(unsigned char *image, int width, int height, int length);
+
+// Halftone
+void update_pixel(unsigned char* image,int width, int col,int row ,int a,int b,int c,int d);
+unsigned char * haftone(unsigned char * image, int width, int height);
+void compressImage(const unsigned char* old_Image, unsigned char* new_Image);
+
+// Dithering
+unsigned char* floydSteinbergTo16Grayscale(const unsigned char* image, int width, int height);
+
+// RGBA to single channel luma
+unsigned char * Grayscale(unsigned char * image, int length);
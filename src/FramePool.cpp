@@ -0,0 +1,237 @@
+#include <FramePool.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#ifdef _WIN32
+    #include <malloc.h>
+#endif
+
+namespace
+{
+    const int kMinShift = 12;                       // smallest block is one page
+    const int kMaxShift = 31;                       // blocks above 2 GB are not pooled
+    const int kBuckets = 1 + (kMaxShift - kMinShift) * 4;
+    const size_t kPageSize = 4096;
+
+    const size_t kThreadBlocksPerBucket = 4;
+    const size_t kThreadCacheBytes = (size_t)128 << 20;
+    const size_t kSharedCacheBytes = (size_t)1 << 30;
+
+    // Bucket index and block size for a request, -1 when it is too big to pool
+    int bucketOf(size_t bytes, size_t& block)
+    {
+        if (bytes <= ((size_t)1 << kMinShift))
+        {
+            block = (size_t)1 << kMinShift;
+            return 0;
+        }
+        const int shift = 63 - __builtin_clzll((unsigned long long)(bytes - 1));   // 2^shift < bytes <= 2^(shift + 1)
+        if (shift >= kMaxShift)
+        {
+            block = (bytes + FramePool::kAlignment - 1) / FramePool::kAlignment * FramePool::kAlignment;
+            return -1;
+        }
+        const size_t base = (size_t)1 << shift, quarter = base >> 2;
+        const size_t steps = (bytes - base + quarter - 1) / quarter;                 // 1..4
+        block = base + steps * quarter;
+        return 1 + (shift - kMinShift) * 4 + (int)(steps - 1);
+    }
+
+    // Inverse of bucketOf()
+    size_t blockSizeOf(int bucket)
+    {
+        if (bucket == 0)
+            return (size_t)1 << kMinShift;
+        const size_t base = (size_t)1 << (kMinShift + (bucket - 1) / 4);
+        return base + (size_t)((bucket - 1) % 4 + 1) * (base >> 2);
+    }
+
+    // MinGW and MSVC have no std::aligned_alloc, and their aligned blocks need their own free
+    unsigned char* alignedAllocate(size_t block)
+    {
+#ifdef _WIN32
+        return (unsigned char*)_aligned_malloc(block, FramePool::kAlignment);
+#else
+        return (unsigned char*)std::aligned_alloc(FramePool::kAlignment, block);
+#endif
+    }
+
+    void alignedFree(unsigned char* memory)
+    {
+#ifdef _WIN32
+        _aligned_free(memory);
+#else
+        std::free(memory);
+#endif
+    }
+
+    unsigned char* allocateBlock(size_t block)
+    {
+        unsigned char* memory = alignedAllocate(block);
+        if (!memory)
+            throw std::bad_alloc();
+        // Fault every page in now rather than inside some filter's inner loop
+        for (size_t offset = 0; offset < block; offset += kPageSize)
+            memory[offset] = 0;
+        return memory;
+    }
+
+    struct SharedCache
+    {
+        std::mutex mutex;
+        std::vector<unsigned char*> lists[kBuckets];
+        size_t bytes = 0;
+
+        std::atomic<unsigned long long> hits{0}, misses{0};
+        std::atomic<size_t> inUse{0}, peak{0};
+
+        // Takes the block or frees it when the cache is full
+        void Put(unsigned char* memory, int bucket, size_t block)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (bytes + block <= kSharedCacheBytes)
+                {
+                    lists[bucket].push_back(memory);
+                    bytes += block;
+                    return;
+                }
+            }
+            alignedFree(memory);
+        }
+    };
+
+    // Never destroyed: images released during exit still have somewhere to go
+    SharedCache& shared()
+    {
+        static SharedCache* cache = new SharedCache();
+        return *cache;
+    }
+
+    // Set while this thread's cache exists, so releases from later thread_local destructors skip it
+    thread_local bool t_CacheAlive = false;
+
+    struct ThreadCache
+    {
+        std::vector<unsigned char*> lists[kBuckets];
+        size_t bytes = 0;
+
+        ThreadCache() { t_CacheAlive = true; }
+        ~ThreadCache()
+        {
+            t_CacheAlive = false;
+            SharedCache& cache = shared();
+            for (int bucket = 0; bucket < kBuckets; bucket++)
+            {
+                for (unsigned char* memory : lists[bucket])
+                    cache.Put(memory, bucket, blockSizeOf(bucket));
+            }
+        }
+    };
+
+    ThreadCache* threadCache()
+    {
+        thread_local ThreadCache cache;
+        return t_CacheAlive ? &cache : nullptr;
+    }
+}
+
+unsigned char* FramePool::Acquire(size_t bytes)
+{
+    SharedCache& cache = shared();
+    size_t block;
+    const int bucket = bucketOf(bytes, block);
+
+    unsigned char* memory = nullptr;
+    if (bucket >= 0)
+    {
+        ThreadCache* local = threadCache();
+        if (local && !local->lists[bucket].empty())
+        {
+            memory = local->lists[bucket].back();
+            local->lists[bucket].pop_back();
+            local->bytes -= block;
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(cache.mutex);
+            if (!cache.lists[bucket].empty())
+            {
+                memory = cache.lists[bucket].back();
+                cache.lists[bucket].pop_back();
+                cache.bytes -= block;
+            }
+        }
+    }
+
+    if (memory)
+        cache.hits.fetch_add(1, std::memory_order_relaxed);
+    else
+    {
+        memory = allocateBlock(block);
+        cache.misses.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const size_t in_use = cache.inUse.fetch_add(block, std::memory_order_relaxed) + block;
+    size_t peak = cache.peak.load(std::memory_order_relaxed);
+    while (in_use > peak && !cache.peak.compare_exchange_weak(peak, in_use, std::memory_order_relaxed))
+        ;
+    return memory;
+}
+
+void FramePool::Release(unsigned char* block_memory, size_t bytes)
+{
+    if (!block_memory)
+        return;
+    SharedCache& cache = shared();
+    size_t block;
+    const int bucket = bucketOf(bytes, block);
+    cache.inUse.fetch_sub(block, std::memory_order_relaxed);
+
+    if (bucket < 0)
+    {
+        alignedFree(block_memory);
+        return;
+    }
+
+    ThreadCache* local = threadCache();
+    if (local && local->lists[bucket].size() < kThreadBlocksPerBucket && local->bytes + block <= kThreadCacheBytes)
+    {
+        local->lists[bucket].push_back(block_memory);
+        local->bytes += block;
+        return;
+    }
+    cache.Put(block_memory, bucket, block);
+}
+
+FramePoolStats FramePool::GetStats()
+{
+    SharedCache& cache = shared();
+    FramePoolStats stats;
+    stats.hits = cache.hits.load(std::memory_order_relaxed);
+    stats.misses = cache.misses.load(std::memory_order_relaxed);
+    stats.bytesInUse = cache.inUse.load(std::memory_order_relaxed);
+    stats.peakBytesInUse = cache.peak.load(std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        stats.bytesCached = cache.bytes;
+    }
+    return stats;
+}
+
+void FramePool::Trim()
+{
+    SharedCache& cache = shared();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    for (std::vector<unsigned char*>& list : cache.lists)
+    {
+        for (unsigned char* memory : list)
+            alignedFree(memory);
+        list.clear();
+    }
+    cache.bytes = 0;
+}
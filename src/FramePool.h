@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+
+struct FramePoolStats
+{
+    unsigned long long hits;        // served from a cache
+    unsigned long long misses;      // freshly allocated (and pre-faulted)
+    size_t bytesInUse;              // handed out right now, in bucket sizes
+    size_t peakBytesInUse;
+    size_t bytesCached;             // sitting in the shared cache
+};
+
+// Recycles the large, same-sized buffers a stream of images needs, so a steady state
+// does no allocator calls and takes no page faults. Requests are rounded up to size
+// buckets (quarter power of two steps, at most 25% waste). Released blocks go to a small
+// per-thread cache first and spill into a shared one, the rest is freed. Blocks are
+// 64 byte aligned and every page of a new block has been touched.
+// Image takes its pixels from here, so intermediate frames are recycled automatically.
+class FramePool
+{
+    public:
+        static const size_t kAlignment = 64;
+    public:
+        // Block of at least 'bytes', contents undefined
+        static unsigned char* Acquire(size_t bytes);
+
+        // 'bytes' must be what the block was acquired with
+        static void Release(unsigned char* block, size_t bytes);
+
+        static FramePoolStats GetStats();
+
+        // Frees everything in the shared cache (per-thread caches stay)
+        static void Trim();
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <Debugger.h>
+
+// FBO with an RGBA8 colour and a depth renderbuffer, what a window's back buffer is to
+// the offscreen renderer. Bind() also sets the viewport to the whole buffer.
+class Framebuffer
+{
+    private:
+        unsigned int m_RendererID;
+        unsigned int m_ColorID;
+        unsigned int m_DepthID;
+        int m_Width, m_Height;
+    public:
+        Framebuffer(int width, int height);
+        ~Framebuffer();
+
+        Framebuffer(const Framebuffer&) = delete;
+        Framebuffer& operator=(const Framebuffer&) = delete;
+
+        bool IsComplete() const;
+
+        void Bind() const;
+        void Unbind() const;
+
+        inline int GetWidth() const { return m_Width; }
+        inline int GetHeight() const { return m_Height; }
+};
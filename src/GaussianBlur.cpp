@@ -0,0 +1,120 @@
+#include <GaussianBlur.h>
+
+static void gaussianRowScalar(const unsigned char* up, const unsigned char* row, const unsigned char* down,
+                              unsigned char* out, int from, int width)
+{
+    for (int j = from; j < width - 1; j++)
+    {
+        int left = up[j - 1] + 2 * row[j - 1] + down[j - 1];
+        int center = up[j] + 2 * row[j] + down[j];
+        int right = up[j + 1] + 2 * row[j + 1] + down[j + 1];
+        out[j] = (unsigned char)((left + 2 * center + right) >> 4);
+    }
+}
+
+#if defined(GRAPHICS_SSE2)
+// Vertical [1 2 1] of 8 pixels widened to 16 bit lanes
+static inline __m128i verticalSum(__m128i u, __m128i r, __m128i d)
+{
+    return _mm_add_epi16(_mm_add_epi16(u, d), _mm_slli_epi16(r, 1));
+}
+
+static int gaussianRowSSE2(const unsigned char* up, const unsigned char* row, const unsigned char* down,
+                           unsigned char* out, int width)
+{
+    const __m128i zero = _mm_setzero_si128();
+    int j = 1;
+    // 16 outputs per step, reading [j - 1, j + 16]
+    for (; j + 16 < width; j += 16)
+    {
+        __m128i u[3], r[3], d[3];
+        for (int k = 0; k < 3; k++)
+        {
+            u[k] = _mm_loadu_si128((const __m128i*)(up + j - 1 + k));
+            r[k] = _mm_loadu_si128((const __m128i*)(row + j - 1 + k));
+            d[k] = _mm_loadu_si128((const __m128i*)(down + j - 1 + k));
+        }
+
+        __m128i lo[3], hi[3];
+        for (int k = 0; k < 3; k++)
+        {
+            lo[k] = verticalSum(_mm_unpacklo_epi8(u[k], zero), _mm_unpacklo_epi8(r[k], zero), _mm_unpacklo_epi8(d[k], zero));
+            hi[k] = verticalSum(_mm_unpackhi_epi8(u[k], zero), _mm_unpackhi_epi8(r[k], zero), _mm_unpackhi_epi8(d[k], zero));
+        }
+
+        __m128i sumLo = _mm_srli_epi16(verticalSum(lo[0], lo[1], lo[2]), 4);
+        __m128i sumHi = _mm_srli_epi16(verticalSum(hi[0], hi[1], hi[2]), 4);
+        _mm_storeu_si128((__m128i*)(out + j), _mm_packus_epi16(sumLo, sumHi));
+    }
+    return j;
+}
+#endif
+
+#if defined(GRAPHICS_AVX2)
+GRAPHICS_TARGET_AVX2
+static inline __m256i verticalSumAVX2(__m256i u, __m256i r, __m256i d)
+{
+    return _mm256_add_epi16(_mm256_add_epi16(u, d), _mm256_slli_epi16(r, 1));
+}
+
+GRAPHICS_TARGET_AVX2
+static inline __m256i widen16(const unsigned char* p)
+{
+    return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)p));
+}
+
+GRAPHICS_TARGET_AVX2
+static int gaussianRowAVX2(const unsigned char* up, const unsigned char* row, const unsigned char* down,
+                           unsigned char* out, int width)
+{
+    int j = 1;
+    // 32 outputs per step, reading [j - 1, j + 32]
+    for (; j + 32 < width; j += 32)
+    {
+        __m256i sums[2];
+        for (int half = 0; half < 2; half++)
+        {
+            const int base = j - 1 + half * 16;
+            __m256i v[3];
+            for (int k = 0; k < 3; k++)
+            {
+                v[k] = verticalSumAVX2(widen16(up + base + k), widen16(row + base + k), widen16(down + base + k));
+            }
+            sums[half] = _mm256_srli_epi16(verticalSumAVX2(v[0], v[1], v[2]), 4);
+        }
+        // packus works per 128 bit lane, restore the pixel order afterwards
+        __m256i packed = _mm256_packus_epi16(sums[0], sums[1]);
+        packed = _mm256_permute4x64_epi64(packed, 0xD8);
+        _mm256_storeu_si256((__m256i*)(out + j), packed);
+    }
+    return j;
+}
+#endif
+
+void gaussianRow3x3(const unsigned char* up, const unsigned char* row, const unsigned char* down,
+                    unsigned char* out, int width, SimdLevel level)
+{
+    int j = 1;
+    switch (supportedSimdLevel(level))
+    {
+#if defined(GRAPHICS_AVX2)
+        case SimdLevel::AVX2:
+            j = gaussianRowAVX2(up, row, down, out, width);
+            break;
+#endif
+#if defined(GRAPHICS_SSE2)
+        case SimdLevel::SSE2:
+            j = gaussianRowSSE2(up, row, down, out, width);
+            break;
+#endif
+        default:
+            break;
+    }
+    gaussianRowScalar(up, row, down, out, j, width);
+}
+
+void gaussianRow3x3(const unsigned char* up, const unsigned char* row, const unsigned char* down,
+                    unsigned char* out, int width)
+{
+    gaussianRow3x3(up, row, down, out, width, detectSimdLevel());
+}
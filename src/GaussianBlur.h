@@ -0,0 +1,16 @@
+#pragma once
+
+#include <Simd.h>
+
+// 3x3 Gaussian (ker in Filters.cpp) in its separable fixed-point form:
+//   out = ([1 2 1] x [1 2 1]^T * pixels) >> 4
+// The float kernel only holds multiples of 1/16 so this is bit-exact with it.
+
+// Blurs the interior pixels [1, width - 2] of one row given the rows above and below.
+// out[0] and out[width - 1] are not written.
+void gaussianRow3x3(const unsigned char* up, const unsigned char* row, const unsigned char* down,
+                    unsigned char* out, int width);
+
+// Same, forcing a specific implementation (falls back to the best supported one)
+void gaussianRow3x3(const unsigned char* up, const unsigned char* row, const unsigned char* down,
+                    unsigned char* out, int width, SimdLevel level);
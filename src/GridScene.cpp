@@ -0,0 +1,74 @@
+#include <GridScene.h>
+#include <VertexBufferLayout.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+    /* Shape vertices coordinates with positions, colors, and corrected texCoords */
+    /* (in-memory textures are uploaded top row first, so v = 0 is the top of the image) */
+    const float kVertices[] = {
+        // positions            // colors            // texCoords
+        -0.5f, -0.5f,  0.5f,    1.0f, 0.0f, 0.0f,    0.0f, 1.0f,  // Bottom-left
+         0.5f, -0.5f,  0.5f,    0.0f, 1.0f, 0.0f,    1.0f, 1.0f,  // Bottom-right
+         0.5f,  0.5f,  0.5f,    0.0f, 0.0f, 1.0f,    1.0f, 0.0f,  // Top-right
+        -0.5f,  0.5f,  0.5f,    1.0f, 1.0f, 0.0f,    0.0f, 0.0f,  // Top-left
+    };
+
+    /* Indices for vertices order */
+    const unsigned int kIndices[] = {
+        0, 1, 2,
+        2, 3, 0
+    };
+
+    // Centre of each quad, in the order of m_Textures
+    const glm::vec3 kPlacements[4] = {
+        glm::vec3(-0.5f, 0.5f, -1.0f), glm::vec3(0.5f, 0.5f, -1.0f),
+        glm::vec3(-0.5f, -0.5f, -1.0f), glm::vec3(0.5f, -0.5f, -1.0f)
+    };
+}
+
+GridScene::GridScene(const Image& topLeft, const Image& topRight, const Image& bottomLeft, const Image& bottomRight,
+                     const std::string& shaderPath)
+    : m_VertexBuffer(kVertices, sizeof(kVertices)), m_IndexBuffer(kIndices, sizeof(kIndices)), m_Shader(shaderPath),
+      m_Textures{topLeft, topRight, bottomLeft, bottomRight}
+{
+    /* Blend to fix images with transperancy */
+    GLCall(glEnable(GL_BLEND));
+    GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+
+    VertexBufferLayout layout;
+    layout.Push<float>(3);  // positions
+    layout.Push<float>(3);  // colors
+    layout.Push<float>(2);  // texCoords
+    m_VertexArray.AddBuffer(m_VertexBuffer, layout);
+
+    /* Unbind all to prevent accidentally modifying them */
+    m_VertexArray.Unbind();
+    m_VertexBuffer.Unbind();
+    m_IndexBuffer.Unbind();
+    m_Shader.Unbind();
+
+    /* Enables the Depth Buffer */
+    GLCall(glEnable(GL_DEPTH_TEST));
+}
+
+void GridScene::Draw(const glm::mat4& view, const glm::mat4& projection)
+{
+    GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+    GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+
+    glm::vec4 color = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+    m_Shader.Bind();
+    m_Shader.SetUniform4f("u_Color", color);
+    m_Shader.SetUniform1i("u_Texture", 0);
+    m_VertexArray.Bind();
+    m_IndexBuffer.Bind();
+    for (int i = 0; i < 4; i++)
+    {
+        const glm::mat4 model = glm::translate(glm::mat4(1.0f), kPlacements[i]);
+        m_Shader.SetUniformMat4f("u_MVP", projection * view * model);
+        m_Textures[i].Bind(0);
+        GLCall(glDrawElements(GL_TRIANGLES, m_IndexBuffer.GetCount(), GL_UNSIGNED_INT, nullptr));
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <Image.h>
+#include <IndexBuffer.h>
+#include <Shader.h>
+#include <Texture.h>
+#include <VertexArray.h>
+#include <VertexBuffer.h>
+
+#include <glm/glm.hpp>
+
+#include <string>
+
+// The viewer's scene: four images on textured quads in a 2x2 grid. Needs a current
+// GL 3.3 context with glad loaded and draws the same into a window or a Framebuffer.
+class GridScene
+{
+    private:
+        VertexArray m_VertexArray;
+        VertexBuffer m_VertexBuffer;
+        IndexBuffer m_IndexBuffer;
+        Shader m_Shader;
+        Texture m_Textures[4];
+    public:
+        GridScene(const Image& topLeft, const Image& topRight, const Image& bottomLeft, const Image& bottomRight,
+                  const std::string& shaderPath = "res/shaders/basic.shader");
+
+        GridScene(const GridScene&) = delete;
+        GridScene& operator=(const GridScene&) = delete;
+
+        // Clears the bound framebuffer and draws the grid
+        void Draw(const glm::mat4& view, const glm::mat4& projection);
+};
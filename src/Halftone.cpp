@@ -0,0 +1,144 @@
+#include <Halftone.h>
+#include <Simd.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    struct HalftoneTables
+    {
+        unsigned int pattern[256];      // 4 cells packed little endian
+        unsigned short top[256];        // top-left | top-right << 8
+        unsigned short bottom[256];     // bottom-left | bottom-right << 8
+        unsigned char mean[256];        // 2x2 average (rounded down)
+
+        HalftoneTables()
+        {
+            for (int v = 0; v < 256; v++)
+            {
+                // Same thresholds as haftone()
+                unsigned char a, b, c, d;
+                if (v >= 255.0 / 5 * 4)      { a = 255; b = 255; c = 255; d = 255; }
+                else if (v >= 255.0 / 5 * 3) { a = 0;   b = 255; c = 255; d = 255; }
+                else if (v >= 255.0 / 5 * 2) { a = 255; b = 0;   c = 255; d = 0;   }
+                else if (v >= 255.0 / 5)     { a = 0;   b = 0;   c = 255; d = 0;   }
+                else                         { a = 0;   b = 0;   c = 0;   d = 0;   }
+                pattern[v] = a | (b << 8) | (c << 16) | ((unsigned int)d << 24);
+                top[v] = (unsigned short)(a | (b << 8));
+                bottom[v] = (unsigned short)(c | (d << 8));
+                mean[v] = (unsigned char)((a + b + c + d) / 4);
+            }
+        }
+    };
+
+    const HalftoneTables& tables()
+    {
+        static const HalftoneTables instance;
+        return instance;
+    }
+
+    // One row of 2-byte cells from a 16 bit LUT
+    void expandRow(const unsigned char* src, const unsigned short* lut, unsigned char* dst, int width)
+    {
+        int x = 0;
+#if defined(GRAPHICS_SSE2)
+        for (; x + 8 <= width; x += 8)
+        {
+            const unsigned char* s = src + x;
+            __m128i cells = _mm_setr_epi16((short)lut[s[0]], (short)lut[s[1]], (short)lut[s[2]], (short)lut[s[3]],
+                                           (short)lut[s[4]], (short)lut[s[5]], (short)lut[s[6]], (short)lut[s[7]]);
+            _mm_storeu_si128((__m128i*)(dst + 2 * x), cells);
+        }
+#endif
+        for (; x < width; x++)
+        {
+            dst[2 * x] = (unsigned char)(lut[src[x]] & 0xFF);
+            dst[2 * x + 1] = (unsigned char)(lut[src[x]] >> 8);
+        }
+    }
+
+    inline unsigned char cell(const HalftoneTables& t, const unsigned char* src, int srcStride, int vx, int vy)
+    {
+        unsigned int pattern = t.pattern[src[(size_t)(vy >> 1) * srcStride + (vx >> 1)]];
+        return (unsigned char)(pattern >> (((vy & 1) * 2 + (vx & 1)) * 8));
+    }
+}
+
+unsigned int halftonePattern(unsigned char value)
+{
+    return tables().pattern[value];
+}
+
+void fusedHalftone(const unsigned char* src, int width, int height, int srcStride,
+                   unsigned char* dst, int outWidth, int outHeight, int dstStride,
+                   ThreadPool& pool)
+{
+    if (width <= 0 || height <= 0 || outWidth <= 0 || outHeight <= 0)
+        return;
+    if (srcStride == 0)
+        srcStride = width;
+    if (dstStride == 0)
+        dstStride = outWidth;
+
+    const HalftoneTables& t = tables();
+    const int grain = std::max(1, (1 << 15) / outWidth);
+
+    if (outWidth == 2 * width && outHeight == 2 * height)
+    {
+        pool.ParallelRanges(height, grain, [&](int first, int last)
+        {
+            for (int y = first; y < last; y++)
+            {
+                expandRow(src + (size_t)y * srcStride, t.top, dst + (size_t)(2 * y) * dstStride, width);
+                expandRow(src + (size_t)y * srcStride, t.bottom, dst + (size_t)(2 * y + 1) * dstStride, width);
+            }
+        });
+        return;
+    }
+
+    if (outWidth == width && outHeight == height)
+    {
+        pool.ParallelRanges(height, grain, [&](int first, int last)
+        {
+            for (int y = first; y < last; y++)
+            {
+                const unsigned char* s = src + (size_t)y * srcStride;
+                unsigned char* d = dst + (size_t)y * dstStride;
+                for (int x = 0; x < width; x++)
+                    d[x] = t.mean[s[x]];
+            }
+        });
+        return;
+    }
+
+    // Footprint of every output column / row in the virtual halftone grid
+    const int virtualWidth = 2 * width, virtualHeight = 2 * height;
+    std::vector<int> columns(outWidth + 1), rows(outHeight + 1);
+    for (int x = 0; x <= outWidth; x++)
+        columns[x] = (int)((long long)x * virtualWidth / outWidth);
+    for (int y = 0; y <= outHeight; y++)
+        rows[y] = (int)((long long)y * virtualHeight / outHeight);
+
+    pool.ParallelRanges(outHeight, grain, [&](int first, int last)
+    {
+        for (int y = first; y < last; y++)
+        {
+            const int y0 = std::min(rows[y], virtualHeight - 1);
+            const int y1 = std::max(y0 + 1, rows[y + 1]);
+            unsigned char* d = dst + (size_t)y * dstStride;
+            for (int x = 0; x < outWidth; x++)
+            {
+                const int x0 = std::min(columns[x], virtualWidth - 1);
+                const int x1 = std::max(x0 + 1, columns[x + 1]);
+                int sum = 0;
+                for (int vy = y0; vy < y1; vy++)
+                {
+                    for (int vx = x0; vx < x1; vx++)
+                        sum += cell(t, src, srcStride, vx, vy);
+                }
+                d[x] = (unsigned char)(sum / ((x1 - x0) * (y1 - y0)));
+            }
+        }
+    });
+}
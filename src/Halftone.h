@@ -0,0 +1,19 @@
+#pragma once
+
+#include <ThreadPool.h>
+
+// haftone() maps every pixel to a 2x2 pattern (5 levels, see update_pixel() calls) and
+// compressImage() box-averages the 2x wide result back down. This does both in one pass
+// without the 4x temporary: a 256-entry LUT gives each grey value's pattern, and every
+// output pixel averages the pattern cells its footprint covers in the virtual
+// (2 * width) x (2 * height) halftone.
+//   outWidth == 2 * width  -> the pattern itself (vectorized LUT stores)
+//   outWidth == width      -> each pixel's pattern mean (single LUT lookup)
+//   anything else          -> integer box footprint, sum / count like compressImage()
+// Strides are in bytes, 0 means tightly packed.
+void fusedHalftone(const unsigned char* src, int width, int height, int srcStride,
+                   unsigned char* dst, int outWidth, int outHeight, int dstStride,
+                   ThreadPool& pool = ThreadPool::Global());
+
+// Pattern of a grey value: bytes are top-left, top-right, bottom-left, bottom-right
+unsigned int halftonePattern(unsigned char value);
@@ -0,0 +1,182 @@
+#include <HysteresisEngine.h>
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+void hysteresisTrace(const unsigned char* edges, unsigned char* out, int width, int height)
+{
+    const size_t length = (size_t)width * height;
+    if (out != edges)
+        std::memcpy(out, edges, length);
+
+    // Seed with strong pixels; a weak pixel is turned into 255 when first reached so
+    // every pixel is pushed at most once
+    std::vector<int> stack;
+    for (size_t i = 0; i < length; i++)
+    {
+        if (out[i] == 255)
+            stack.push_back((int)i);
+    }
+
+    while (!stack.empty())
+    {
+        int p = stack.back();
+        stack.pop_back();
+        int y = p / width, x = p % width;
+        for (int dy = -1; dy <= 1; dy++)
+        {
+            int ny = y + dy;
+            if (ny < 0 || ny >= height)
+                continue;
+            for (int dx = -1; dx <= 1; dx++)
+            {
+                int nx = x + dx;
+                if (nx < 0 || nx >= width)
+                    continue;
+                int q = ny * width + nx;
+                if (out[q] == 1)
+                {
+                    out[q] = 255;
+                    stack.push_back(q);
+                }
+            }
+        }
+    }
+
+    // Weak pixels that were never reached
+    for (size_t i = 0; i < length; i++)
+    {
+        if (out[i] != 255)
+            out[i] = 0;
+    }
+}
+
+namespace
+{
+    // Labels are pixel indices; the smaller index always becomes the root
+    struct UnionFind
+    {
+        std::vector<unsigned int> parent;
+        std::vector<unsigned char> strong;
+
+        unsigned int Find(unsigned int p)
+        {
+            while (parent[p] != p)
+            {
+                parent[p] = parent[parent[p]]; // path halving
+                p = parent[p];
+            }
+            return p;
+        }
+
+        // Read only, safe while other threads read too
+        unsigned int Root(unsigned int p) const
+        {
+            while (parent[p] != p)
+                p = parent[p];
+            return p;
+        }
+
+        void Union(unsigned int a, unsigned int b)
+        {
+            a = Find(a);
+            b = Find(b);
+            if (a == b)
+                return;
+            if (b < a)
+                std::swap(a, b);
+            parent[b] = a;
+            strong[a] |= strong[b];
+        }
+    };
+}
+
+void hysteresisUnionFind(const unsigned char* edges, unsigned char* out, int width, int height,
+                         TileExecutor& executor, int stride)
+{
+    const size_t length = (size_t)width * height;
+    if (stride == 0)
+        stride = width;
+    // Labels are indexed y * width + x, pixels y * stride + x
+    auto edge = [&](int x, int y) { return edges[(size_t)y * stride + x]; };
+    UnionFind sets;
+    sets.parent.resize(length);
+    sets.strong.resize(length);
+
+    std::vector<Tile> tiles = executor.MakeTiles(width, height, 0);
+
+    // 1) Label edge pixels inside each tile. Only the tile's own pixels are touched.
+    executor.GetPool().ParallelFor((int)tiles.size(), [&](int t)
+    {
+        const Tile& tile = tiles[t];
+        for (int y = tile.y; y < tile.y + tile.height; y++)
+        {
+            for (int x = tile.x; x < tile.x + tile.width; x++)
+            {
+                unsigned int p = (unsigned int)y * width + x;
+                sets.parent[p] = p;
+                sets.strong[p] = edge(x, y) == 255;
+                if (edge(x, y) == 0)
+                    continue;
+                // Neighbours already visited in scan order: left, and the three above
+                if (x > tile.x && edge(x - 1, y))
+                    sets.Union(p, p - 1);
+                if (y > tile.y)
+                {
+                    for (int dx = -1; dx <= 1; dx++)
+                    {
+                        int nx = x + dx;
+                        if (nx >= tile.x && nx < tile.x + tile.width && edge(nx, y - 1))
+                            sets.Union(p, p - width + dx);
+                    }
+                }
+            }
+        }
+    });
+
+    // 2) Merge across tile borders. Every cross-tile adjacency has one pixel on the last
+    //    row or column of its tile, so only those pixels need to look outside.
+    for (const Tile& tile : tiles)
+    {
+        const int lastX = tile.x + tile.width - 1, lastY = tile.y + tile.height - 1;
+        for (int y = tile.y; y <= lastY; y++)
+        {
+            for (int x = tile.x; x <= lastX; x++)
+            {
+                if (x != lastX && y != lastY)
+                    x = lastX; // skip the tile interior
+                unsigned int p = (unsigned int)y * width + x;
+                if (edge(x, y) == 0)
+                    continue;
+                for (int dy = -1; dy <= 1; dy++)
+                {
+                    for (int dx = -1; dx <= 1; dx++)
+                    {
+                        int nx = x + dx, ny = y + dy;
+                        if (nx < 0 || ny < 0 || nx >= width || ny >= height)
+                            continue;
+                        bool inside = nx >= tile.x && nx <= lastX && ny >= tile.y && ny <= lastY;
+                        unsigned int q = (unsigned int)ny * width + nx;
+                        if (!inside && edge(nx, ny))
+                            sets.Union(p, q);
+                    }
+                }
+            }
+        }
+    }
+
+    // 3) An edge pixel survives when its component holds a strong pixel
+    executor.GetPool().ParallelFor((int)tiles.size(), [&](int t)
+    {
+        const Tile& tile = tiles[t];
+        for (int y = tile.y; y < tile.y + tile.height; y++)
+        {
+            for (int x = tile.x; x < tile.x + tile.width; x++)
+            {
+                unsigned int p = (unsigned int)y * width + x;
+                out[(size_t)y * stride + x] = (edge(x, y) && sets.strong[sets.Root(p)]) ? 255 : 0;
+            }
+        }
+    });
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <TileExecutor.h>
+
+// Full hysteresis over a thresholded edge map (0 = no edge, 1 = weak, 255 = strong).
+// A weak pixel becomes an edge when it is 8-connected to a strong pixel through any
+// chain of weak pixels, not only when it touches one directly like Hysteresis() does.
+// Output is 255 for edges and 0 elsewhere. Both versions are O(pixels), independent of
+// chain length, and produce identical maps. 'out' may alias 'edges'.
+
+// Serial: a stack seeded with every strong pixel, grown into weak neighbours
+void hysteresisTrace(const unsigned char* edges, unsigned char* out, int width, int height);
+
+// Parallel: union-find labelling per tile, then labels are merged across tile borders.
+// 'stride' is the row pitch of both maps in bytes, 0 means tightly packed.
+void hysteresisUnionFind(const unsigned char* edges, unsigned char* out, int width, int height,
+                         TileExecutor& executor, int stride = 0);
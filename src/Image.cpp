@@ -0,0 +1,176 @@
+#include <stb/stb_image.h>
+
+#include <Image.h>
+#include <FramePool.h>
+#include <MappedImage.h>
+#include <Profiler.h>
+
+#include <cstring>
+#include <utility>
+
+namespace
+{
+    // Channel conversion for files stb_image doesn't decode, with stb's rules: grey
+    // expands to RGB, missing alpha is opaque, colour reduces to stbi__compute_y() luma
+    void convertChannels(ConstImageView src, ImageView dst)
+    {
+        const int from = src.GetChannels(), to = dst.GetChannels();
+        for (int y = 0; y < src.GetHeight(); y++)
+        {
+            const unsigned char* s = src.GetRow(y);
+            unsigned char* d = dst.GetRow(y);
+            for (int x = 0; x < src.GetWidth(); x++, s += from, d += to)
+            {
+                const bool colour = from >= 3;
+                const unsigned char r = s[0], g = colour ? s[1] : s[0], b = colour ? s[2] : s[0];
+                const unsigned char a = from == 2 ? s[1] : from == 4 ? s[3] : 255;
+                if (to <= 2)
+                {
+                    d[0] = colour ? (unsigned char)((r * 77 + g * 150 + b * 29) >> 8) : r;
+                }
+                else
+                {
+                    d[0] = r;
+                    d[1] = g;
+                    d[2] = b;
+                }
+                if (to == 2 || to == 4)
+                    d[to - 1] = a;
+            }
+        }
+    }
+}
+
+void Image::PoolRelease::operator()(unsigned char* pixels) const
+{
+    FramePool::Release(pixels, bytes);
+}
+
+Image::Image()
+    : m_Width(0), m_Height(0), m_Channels(0), m_Stride(0)
+{
+}
+
+Image::Image(int width, int height, int channels)
+    : m_Width(width), m_Height(height), m_Channels(channels), m_Stride(AlignedStride(width, channels))
+{
+    if (width <= 0 || height <= 0 || channels <= 0)
+    {
+        m_Width = m_Height = m_Stride = 0;
+        return;
+    }
+
+    const size_t bytes = GetSize() + kPadding;
+    unsigned char* pixels = FramePool::Acquire(bytes);
+    m_Pixels = std::unique_ptr<unsigned char[], PoolRelease>(pixels, PoolRelease{bytes});
+
+    // Only the bytes no stage writes are cleared: the padding at the row ends and after
+    // the last row, which SIMD loads past a row end may pick up
+    const size_t row = (size_t)width * channels;
+    if (row < (size_t)m_Stride)
+    {
+        for (int y = 0; y < height; y++)
+            std::memset(GetRow(y) + row, 0, m_Stride - row);
+    }
+    std::memset(pixels + GetSize(), 0, kPadding);
+}
+
+Image Image::Zeroed(int width, int height, int channels)
+{
+    Image image(width, height, channels);
+    if (!image.IsEmpty())
+        std::memset(image.GetData(), 0, image.GetSize());
+    return image;
+}
+
+Image::Image(Image&& other) noexcept
+    : m_Width(other.m_Width), m_Height(other.m_Height), m_Channels(other.m_Channels), m_Stride(other.m_Stride),
+      m_Pixels(std::move(other.m_Pixels))
+{
+    other.m_Width = other.m_Height = other.m_Channels = other.m_Stride = 0;
+}
+
+Image& Image::operator=(Image&& other) noexcept
+{
+    if (this != &other)
+    {
+        m_Width = other.m_Width;
+        m_Height = other.m_Height;
+        m_Channels = other.m_Channels;
+        m_Stride = other.m_Stride;
+        m_Pixels = std::move(other.m_Pixels);
+        other.m_Width = other.m_Height = other.m_Channels = other.m_Stride = 0;
+    }
+    return *this;
+}
+
+int Image::AlignedStride(int width, int channels)
+{
+    if (width <= 0 || channels <= 0)
+        return 0;
+    // Smallest step that is both 64 byte aligned and a whole number of pixels (192 for RGB)
+    int step = kAlignment;
+    while (step % channels != 0)
+        step += kAlignment;
+    const int row = width * channels;
+    return (row + step - 1) / step * step;
+}
+
+Image Image::Load(const std::string& filepath, int channels)
+{
+    PROFILE_SCOPE("Image::Load");
+    if (isPamFile(filepath))
+    {
+        MappedImage file = MappedImage::Open(filepath);
+        if (file.IsEmpty() || channels < 1 || channels > 4)
+            return Image();
+        Image image(file.GetWidth(), file.GetHeight(), channels);
+        if (file.GetChannels() == channels)
+            copyPixels(file.View(), image.View());
+        else
+            convertChannels(file.View(), image.View());
+        return image;
+    }
+
+    int width, height, comps;
+    unsigned char* buffer = stbi_load(filepath.c_str(), &width, &height, &comps, channels);
+    if (!buffer)
+        return Image();
+
+    Image image(width, height, channels);
+    copyPixels(ConstImageView(buffer, width, height, channels), image.View());
+    stbi_image_free(buffer);
+    return image;
+}
+
+Image Image::Clone() const
+{
+    Image image(m_Width, m_Height, m_Channels);
+    if (!IsEmpty())
+        std::memcpy(image.GetData(), GetData(), GetSize());
+    return image;
+}
+
+bool Image::SavePNG(const std::string& filepath, const PngOptions& options) const
+{
+    PROFILE_SCOPE("Image::SavePNG");
+    return !IsEmpty() && writePng(filepath, View(), options);
+}
+
+bool Image::SaveRaw(const std::string& filepath) const
+{
+    PROFILE_SCOPE("Image::SaveRaw");
+    return !IsEmpty() && saveRawImage(filepath, View());
+}
+
+void copyPixels(ConstImageView src, ImageView dst)
+{
+    const size_t row = (size_t)src.GetWidth() * src.GetChannels();
+    if (src.IsContiguous() && dst.IsContiguous())
+    {
+        std::memcpy(dst.GetData(), src.GetData(), row * src.GetHeight());
+        return;
+    }
+    for (int y = 0; y < src.GetHeight(); y++)
+        std::memcpy(dst.GetRow(y), src.GetRow(y), row);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <ImageView.h>
+#include <PngWriter.h>
+
+#include <memory>
+#include <string>
+
+// Owning 8 bit image with 1 to 4 interleaved channels.
+// Rows start on 64 byte boundaries and are padded to a whole number of pixels, and
+// kPadding spare bytes follow the last row, so SIMD loops may load a full vector past
+// the end of any row. Move-only: copies are explicit through Clone().
+// Storage comes from the FramePool and goes back to it when the image dies.
+class Image
+{
+    public:
+        static const int kAlignment = 64;
+        static const int kPadding = 64;
+    private:
+        // Hands the pixels back to the FramePool
+        struct PoolRelease
+        {
+            size_t bytes;
+            void operator()(unsigned char* pixels) const;
+        };
+
+        int m_Width, m_Height, m_Channels, m_Stride;
+        std::unique_ptr<unsigned char[], PoolRelease> m_Pixels;
+    public:
+        Image();
+        // Pixels start uninitialised (the row and tail padding is zeroed), every caller
+        // writes the whole image. Zeroed() is for the ones that don't.
+        Image(int width, int height, int channels);
+
+        // Same with every pixel set to 0
+        static Image Zeroed(int width, int height, int channels);
+
+        Image(Image&& other) noexcept;
+        Image& operator=(Image&& other) noexcept;
+        Image(const Image&) = delete;
+        Image& operator=(const Image&) = delete;
+
+        // Decodes a file with stb_image (PAM files are mapped instead), forcing 'channels'
+        // components. Returns an empty image on failure.
+        static Image Load(const std::string& filepath, int channels);
+
+        // Same size and pixels, new storage
+        Image Clone() const;
+
+        // Encodes as PNG (see encodePng()), returns false on failure
+        bool SavePNG(const std::string& filepath, const PngOptions& options = PngOptions()) const;
+
+        // Writes an uncompressed PAM (see MappedImage), about the cost of a memcpy
+        bool SaveRaw(const std::string& filepath) const;
+
+        inline ImageView View() { return ImageView(m_Pixels.get(), m_Width, m_Height, m_Channels, m_Stride); }
+        inline ConstImageView View() const { return ConstImageView(m_Pixels.get(), m_Width, m_Height, m_Channels, m_Stride); }
+        inline ImageView Crop(int x, int y, int width, int height) { return View().Crop(x, y, width, height); }
+        inline ConstImageView Crop(int x, int y, int width, int height) const { return View().Crop(x, y, width, height); }
+
+        inline unsigned char* GetData() { return m_Pixels.get(); }
+        inline const unsigned char* GetData() const { return m_Pixels.get(); }
+        inline unsigned char* GetRow(int y) { return m_Pixels.get() + (size_t)y * m_Stride; }
+        inline const unsigned char* GetRow(int y) const { return m_Pixels.get() + (size_t)y * m_Stride; }
+
+        inline int GetWidth() const { return m_Width; }
+        inline int GetHeight() const { return m_Height; }
+        inline int GetChannels() const { return m_Channels; }
+        // Bytes from one row to the next, a multiple of kAlignment
+        inline int GetStride() const { return m_Stride; }
+        // Bytes covered by the rows (stride * height), without the tail padding
+        inline size_t GetSize() const { return (size_t)m_Stride * m_Height; }
+        inline bool IsEmpty() const { return !m_Pixels; }
+
+        // Row pitch an image of this width and channel count gets
+        static int AlignedStride(int width, int channels);
+};
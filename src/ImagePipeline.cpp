@@ -0,0 +1,90 @@
+#include <ImagePipeline.h>
+#include <ColorConvert.h>
+#include <Halftone.h>
+#include <ParallelFilters.h>
+#include <Profiler.h>
+
+#include <iostream>
+
+ImagePipeline::ImagePipeline(TileExecutor& executor, const PipelineOptions& options)
+    : m_Executor(executor), m_Options(options), m_Writer(options.png)
+{
+}
+
+PipelineResult ImagePipeline::Run(const Image& input)
+{
+    PROFILE_SCOPE("ImagePipeline::Run");
+    PipelineResult result;
+    const int width = input.GetWidth();
+    const int height = input.GetHeight();
+
+    // Grayscale
+    {
+        PROFILE_SCOPE("Grayscale");
+        result.grayscale = Image(width, height, 1);
+        lumaImage(input.GetData(), input.GetStride(), PixelFormat::RGBA, result.grayscale.GetData(),
+                  result.grayscale.GetStride(), width, height, m_Executor.GetPool());
+    }
+    Emit("Grayscale", result.grayscale);
+    Log("grayscale is out");
+
+    // Canny
+    {
+        PROFILE_SCOPE("Canny");
+        result.canny = Image(width, height, 1);
+        cannyTiled(result.grayscale.View(), result.canny.View(), m_Executor, m_Options.canny);
+    }
+    Emit("Canny", result.canny);
+    Log("Canny is out");
+
+    // Haftone
+    const int halftone_width = m_Options.halftoneWidth > 0 ? m_Options.halftoneWidth : width;
+    const int halftone_height = m_Options.halftoneHeight > 0 ? m_Options.halftoneHeight : height;
+    {
+        PROFILE_SCOPE("Halftone");
+        result.halftone = Image(halftone_width, halftone_height, 1);
+        fusedHalftone(result.grayscale.GetData(), width, height, result.grayscale.GetStride(),
+                      result.halftone.GetData(), halftone_width, halftone_height, result.halftone.GetStride(),
+                      m_Executor.GetPool());
+    }
+    Emit("Haftone", result.halftone);
+    Log("Haftone is out");
+
+    // Floyed
+    {
+        PROFILE_SCOPE("Floyd-Steinberg");
+        result.floyd = Image(width, height, 1);
+        errorDiffusionDither(m_Options.ditherKernel, result.grayscale.GetData(), width, height, result.grayscale.GetStride(),
+                             result.floyd.GetData(), result.floyd.GetStride(), m_Options.dither, m_Executor.GetPool());
+    }
+    Emit("FloyedSteinberg", result.floyd);
+    Log("Floyed is out");
+
+    return result;
+}
+
+void ImagePipeline::Flush()
+{
+    m_Writer.Flush();
+}
+
+void ImagePipeline::Log(const char* message)
+{
+    if (m_Options.logStages)
+        std::cout << message << std::endl;
+}
+
+void ImagePipeline::Emit(const std::string& name, const Image& image)
+{
+    if (!m_Options.writeOutputs)
+        return;
+    PROFILE_SCOPE("ImagePipeline::Emit");
+    if (m_Options.rawOutputs)
+    {
+        const std::string filepath = m_Options.outputDirectory + name + ".pam";
+        if (!image.SaveRaw(filepath))
+            std::cout << "Failed to write " << filepath << std::endl;
+        return;
+    }
+    m_Writer.Write(m_Options.outputDirectory + name + ".png", image.Clone());
+}
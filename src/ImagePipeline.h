@@ -0,0 +1,62 @@
+#pragma once
+
+#include <AsyncImageWriter.h>
+#include <CannyEngine.h>
+#include <Dither.h>
+#include <Image.h>
+#include <TileExecutor.h>
+
+#include <string>
+
+struct PipelineOptions
+{
+    // PNG copies of every output are written in the background when enabled
+    bool writeOutputs = true;
+    std::string outputDirectory = "res/textures/";
+    // Dumps uncompressed PAMs (<name>.pam) on this thread instead, no PNG encode
+    bool rawOutputs = false;
+    // Compression level and strips of the PNG encoder
+    PngOptions png;
+    // Prints a line as each stage finishes
+    bool logStages = true;
+    CannyParams canny;
+
+    // Size of the halftone output, 0 means the input size (2 * input size keeps the raw 2x2 patterns)
+    int halftoneWidth = 0;
+    int halftoneHeight = 0;
+
+    // Floyd-Steinberg runs as a wavefront on the executor's pool unless serpentine is asked for
+    DitherOptions dither = {false, true};
+    DiffusionKernel ditherKernel = DiffusionKernel::FloydSteinberg;
+};
+
+struct PipelineResult
+{
+    Image grayscale;
+    Image canny;
+    Image halftone;
+    Image floyd;
+};
+
+// Grayscale -> Canny / Halftone / Floyd-Steinberg with every hand-off in memory.
+// Files are only sinks: nothing is read back from disk between stages.
+class ImagePipeline
+{
+    private:
+        TileExecutor& m_Executor;
+        PipelineOptions m_Options;
+        AsyncImageWriter m_Writer;
+    public:
+        ImagePipeline(TileExecutor& executor, const PipelineOptions& options = PipelineOptions());
+
+        // 'input' must be RGBA (4 channels)
+        PipelineResult Run(const Image& input);
+
+        // Waits until the output files of every Run() so far are written
+        void Flush();
+
+        inline const PipelineOptions& GetOptions() const { return m_Options; }
+    private:
+        void Emit(const std::string& name, const Image& image);
+        void Log(const char* message);
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+
+// Non-owning window onto 8 bit interleaved pixels. Rows are 'stride' bytes apart, so a
+// view can be a crop of a bigger image without copying. Cheap to pass by value.
+template <typename T>
+class BasicImageView
+{
+    private:
+        T* m_Data;
+        int m_Width, m_Height, m_Channels, m_Stride;
+    public:
+        BasicImageView()
+            : m_Data(nullptr), m_Width(0), m_Height(0), m_Channels(0), m_Stride(0) {}
+
+        // 'stride' is in bytes, 0 means tightly packed
+        BasicImageView(T* data, int width, int height, int channels = 1, int stride = 0)
+            : m_Data(data), m_Width(width), m_Height(height), m_Channels(channels),
+              m_Stride(stride ? stride : width * channels) {}
+
+        // A writable view converts to a read-only one
+        template <typename U>
+        BasicImageView(const BasicImageView<U>& other)
+            : m_Data(other.GetData()), m_Width(other.GetWidth()), m_Height(other.GetHeight()),
+              m_Channels(other.GetChannels()), m_Stride(other.GetStride()) {}
+
+        // Sub-rectangle in pixels, shares the pixels and the stride
+        inline BasicImageView Crop(int x, int y, int width, int height) const
+        {
+            return BasicImageView(m_Data + (size_t)y * m_Stride + (size_t)x * m_Channels, width, height, m_Channels, m_Stride);
+        }
+
+        inline T* GetData() const { return m_Data; }
+        inline T* GetRow(int y) const { return m_Data + (size_t)y * m_Stride; }
+        inline T* GetPixel(int x, int y) const { return GetRow(y) + (size_t)x * m_Channels; }
+
+        inline int GetWidth() const { return m_Width; }
+        inline int GetHeight() const { return m_Height; }
+        inline int GetChannels() const { return m_Channels; }
+        inline int GetStride() const { return m_Stride; }
+        inline bool IsEmpty() const { return m_Data == nullptr || m_Width <= 0 || m_Height <= 0; }
+        inline bool IsContiguous() const { return m_Stride == m_Width * m_Channels; }
+};
+
+typedef BasicImageView<unsigned char> ImageView;
+typedef BasicImageView<const unsigned char> ConstImageView;
+
+// Copies the pixels of 'src' into 'dst', both must have the same size and channel count
+void copyPixels(ConstImageView src, ImageView dst);
@@ -0,0 +1,290 @@
+#include <IntegralImage.h>
+
+namespace
+{
+#if defined(GRAPHICS_SSE2)
+    // Inclusive prefix sums of 4 32 bit lanes
+    inline __m128i scan4(__m128i v)
+    {
+        v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+        return _mm_add_epi32(v, _mm_slli_si128(v, 8));
+    }
+
+    // out[i] = above[i] + carry + run[i] for 4 entries, 'run' being a scan4(). The carry
+    // moves on by the run's total.
+    inline void addRun(const unsigned int* above, unsigned int* out, __m128i run, unsigned int& carry)
+    {
+        const __m128i sums = _mm_add_epi32(run, _mm_set1_epi32((int)carry));
+        _mm_storeu_si128((__m128i*)out, _mm_add_epi32(sums, _mm_loadu_si128((const __m128i*)above)));
+        carry += (unsigned int)_mm_cvtsi128_si32(_mm_shuffle_epi32(run, 0xFF));
+    }
+
+    inline void addRun(const unsigned long long* above, unsigned long long* out, __m128i run, unsigned long long& carry)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i base = _mm_set1_epi64x((long long)carry);
+        const __m128i lo = _mm_add_epi64(_mm_unpacklo_epi32(run, zero), base);
+        const __m128i hi = _mm_add_epi64(_mm_unpackhi_epi32(run, zero), base);
+        _mm_storeu_si128((__m128i*)out, _mm_add_epi64(lo, _mm_loadu_si128((const __m128i*)above)));
+        _mm_storeu_si128((__m128i*)(out + 2), _mm_add_epi64(hi, _mm_loadu_si128((const __m128i*)(above + 2))));
+        carry += (unsigned int)_mm_cvtsi128_si32(_mm_shuffle_epi32(run, 0xFF));
+    }
+
+    // 16 pixels per step, returns the first one left to the scalar loop
+    template <typename T>
+    int scanRowSSE2(const unsigned char* src, int width, const T* above, T* out, const T* aboveSquares,
+                    T* outSquares, T& sum, T& square)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        int x = 0;
+        for (; x + 16 <= width; x += 16)
+        {
+            const __m128i bytes = _mm_loadu_si128((const __m128i*)(src + x));
+            const __m128i words[2] = {_mm_unpacklo_epi8(bytes, zero), _mm_unpackhi_epi8(bytes, zero)};
+            for (int h = 0; h < 2; h++)
+            {
+                const int at = x + 8 * h + 1;
+                addRun(above + at, out + at, scan4(_mm_unpacklo_epi16(words[h], zero)), sum);
+                addRun(above + at + 4, out + at + 4, scan4(_mm_unpackhi_epi16(words[h], zero)), sum);
+                if (outSquares)
+                {
+                    // 255^2 still fits an unsigned 16 bit product
+                    const __m128i squared = _mm_mullo_epi16(words[h], words[h]);
+                    addRun(aboveSquares + at, outSquares + at, scan4(_mm_unpacklo_epi16(squared, zero)), square);
+                    addRun(aboveSquares + at + 4, outSquares + at + 4, scan4(_mm_unpackhi_epi16(squared, zero)), square);
+                }
+            }
+        }
+        return x;
+    }
+#endif
+
+#if defined(GRAPHICS_AVX2)
+    // Inclusive prefix sums of 8 32 bit lanes: within each 128 bit half, then the low
+    // half's total is added to the high half
+    GRAPHICS_TARGET_AVX2
+    inline __m256i scan8(__m256i v)
+    {
+        v = _mm256_add_epi32(v, _mm256_slli_si256(v, 4));
+        v = _mm256_add_epi32(v, _mm256_slli_si256(v, 8));
+        const __m256i low_total = _mm256_shuffle_epi32(_mm256_permute2x128_si256(v, v, 0x08), 0xFF);
+        return _mm256_add_epi32(v, low_total);
+    }
+
+    GRAPHICS_TARGET_AVX2
+    inline void addRun(const unsigned int* above, unsigned int* out, __m256i run, unsigned int& carry)
+    {
+        const __m256i sums = _mm256_add_epi32(run, _mm256_set1_epi32((int)carry));
+        _mm256_storeu_si256((__m256i*)out, _mm256_add_epi32(sums, _mm256_loadu_si256((const __m256i*)above)));
+        carry += (unsigned int)_mm256_extract_epi32(run, 7);
+    }
+
+    GRAPHICS_TARGET_AVX2
+    inline void addRun(const unsigned long long* above, unsigned long long* out, __m256i run, unsigned long long& carry)
+    {
+        const __m256i base = _mm256_set1_epi64x((long long)carry);
+        const __m256i lo = _mm256_add_epi64(_mm256_cvtepu32_epi64(_mm256_castsi256_si128(run)), base);
+        const __m256i hi = _mm256_add_epi64(_mm256_cvtepu32_epi64(_mm256_extracti128_si256(run, 1)), base);
+        _mm256_storeu_si256((__m256i*)out, _mm256_add_epi64(lo, _mm256_loadu_si256((const __m256i*)above)));
+        _mm256_storeu_si256((__m256i*)(out + 4), _mm256_add_epi64(hi, _mm256_loadu_si256((const __m256i*)(above + 4))));
+        carry += (unsigned int)_mm256_extract_epi32(run, 7);
+    }
+
+    // 8 pixels per step, returns the first one left to the scalar loop
+    template <typename T>
+    GRAPHICS_TARGET_AVX2
+    int scanRowAVX2(const unsigned char* src, int width, const T* above, T* out, const T* aboveSquares,
+                    T* outSquares, T& sum, T& square)
+    {
+        int x = 0;
+        for (; x + 8 <= width; x += 8)
+        {
+            const __m256i pixels = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src + x)));
+            addRun(above + x + 1, out + x + 1, scan8(pixels), sum);
+            if (outSquares)
+                addRun(aboveSquares + x + 1, outSquares + x + 1, scan8(_mm256_mullo_epi32(pixels, pixels)), square);
+        }
+        return x;
+    }
+#endif
+
+    // One table row: out[x + 1] = above[x + 1] + src[0] + ... + src[x], and the same for
+    // the squares when 'outSquares' is set. out[0] is the zero column.
+    template <typename T>
+    void scanRow(const unsigned char* src, int width, const T* above, T* out, const T* aboveSquares, T* outSquares,
+                 SimdLevel level)
+    {
+        T sum = 0, square = 0;
+        int x = 0;
+        switch (level)
+        {
+#if defined(GRAPHICS_AVX2)
+            case SimdLevel::AVX2:
+                x = scanRowAVX2(src, width, above, out, aboveSquares, outSquares, sum, square);
+                break;
+#endif
+#if defined(GRAPHICS_SSE2)
+            case SimdLevel::SSE2:
+                x = scanRowSSE2(src, width, above, out, aboveSquares, outSquares, sum, square);
+                break;
+#endif
+            default:
+                break;
+        }
+
+        out[0] = 0;
+        for (int i = x; i < width; i++)
+        {
+            sum += src[i];
+            out[i + 1] = above[i + 1] + sum;
+        }
+        if (outSquares)
+        {
+            outSquares[0] = 0;
+            for (int i = x; i < width; i++)
+            {
+                square += (T)src[i] * src[i];
+                outSquares[i + 1] = aboveSquares[i + 1] + square;
+            }
+        }
+    }
+
+    template <typename T>
+    void addRow(const T* offset, T* row, int count)
+    {
+        for (int i = 0; i < count; i++)
+            row[i] += offset[i];
+    }
+
+    template <typename T>
+    void boxMeans(const BasicIntegralImage<T>& table, ImageView dst, int radius, ThreadPool& pool)
+    {
+        const int width = table.GetWidth(), height = table.GetHeight();
+        pool.ParallelRanges(height, 16, [&](int first, int last)
+        {
+            for (int y = first; y < last; y++)
+            {
+                const int top = std::max(0, y - radius), bottom = std::min(height, y + radius + 1);
+                unsigned char* out = dst.GetRow(y);
+                for (int x = 0; x < width; x++)
+                {
+                    const int left = std::max(0, x - radius), right = std::min(width, x + radius + 1);
+                    const T count = (T)(right - left) * (T)(bottom - top);
+                    out[x] = (unsigned char)((table.Sum(left, top, right - left, bottom - top) + count / 2) / count);
+                }
+            }
+        });
+    }
+}
+
+template <typename T>
+BasicIntegralImage<T>::BasicIntegralImage()
+    : m_Width(0), m_Height(0), m_Stride(0), m_Capacity(0), m_Sums(nullptr, PoolRelease{0}),
+      m_Squares(nullptr, PoolRelease{0})
+{
+}
+
+template <typename T>
+BasicIntegralImage<T>::BasicIntegralImage(ConstImageView src, bool squares, ThreadPool& pool)
+    : BasicIntegralImage()
+{
+    Build(src, squares, pool);
+}
+
+template <typename T>
+void BasicIntegralImage<T>::Build(ConstImageView src, bool squares, ThreadPool& pool)
+{
+    Build(src, squares, pool, detectSimdLevel());
+}
+
+template <typename T>
+void BasicIntegralImage<T>::Build(ConstImageView src, bool squares, ThreadPool& pool, SimdLevel level)
+{
+    const int width = src.GetWidth(), height = src.GetHeight();
+    const int per_line = 64 / (int)sizeof(T);
+    m_Width = width;
+    m_Height = height;
+    m_Stride = (width + 1 + per_line - 1) / per_line * per_line;
+
+    // Left uninitialised, the scan writes every entry but the padding at the row ends
+    const size_t size = (size_t)m_Stride * (height + 1);
+    if (size != m_Capacity)
+    {
+        m_Sums = AllocateTable(size);
+        m_Squares.reset();
+        m_Capacity = size;
+    }
+    if (squares && !m_Squares)
+        m_Squares = AllocateTable(size);
+    else if (!squares)
+        m_Squares.reset();
+
+    T* sums = m_Sums.get();
+    T* square_sums = m_Squares.get();
+    std::fill(sums, sums + width + 1, (T)0);
+    if (square_sums)
+        std::fill(square_sums, square_sums + width + 1, (T)0);
+    if (src.IsEmpty())
+        return;
+    level = supportedSimdLevel(level);
+
+    auto row = [&](T* table, int y) { return table ? table + (size_t)y * m_Stride : nullptr; };
+
+    // Table row y + 1 holds image row y. Each band starts from the zero row 0 as if it
+    // were the top of the image. One band per thread: all but the first are touched twice.
+    const int bands = std::max(1, std::min((height + 63) / 64, (int)pool.GetThreadCount()));
+    auto bandStart = [&](int band) { return (int)((long long)height * band / bands) + 1; };
+    pool.ParallelFor(bands, [&](int band)
+    {
+        const int first = bandStart(band), last = bandStart(band + 1);
+        for (int y = first; y < last; y++)
+        {
+            const int above = y == first ? 0 : y - 1;
+            scanRow(src.GetRow(y - 1), width, row(sums, above), row(sums, y), row(square_sums, above),
+                    row(square_sums, y), level);
+        }
+    });
+    if (bands == 1)
+        return;
+
+    // The last row of every band, top down, gets the totals of all the bands above it
+    for (int band = 1; band < bands; band++)
+    {
+        const int previous = bandStart(band) - 1, last = bandStart(band + 1) - 1;
+        addRow(row(sums, previous), row(sums, last), width + 1);
+        if (square_sums)
+            addRow(row(square_sums, previous), row(square_sums, last), width + 1);
+    }
+
+    // Then the other rows of the band from the finished last row of the band above
+    pool.ParallelFor(bands - 1, [&](int index)
+    {
+        const int band = index + 1;
+        const int previous = bandStart(band) - 1, last = bandStart(band + 1) - 1;
+        for (int y = previous + 1; y < last; y++)
+        {
+            addRow(row(sums, previous), row(sums, y), width + 1);
+            if (square_sums)
+                addRow(row(square_sums, previous), row(square_sums, y), width + 1);
+        }
+    });
+}
+
+template <typename T>
+std::unique_ptr<T[], typename BasicIntegralImage<T>::PoolRelease> BasicIntegralImage<T>::AllocateTable(size_t size)
+{
+    const size_t bytes = size * sizeof(T);
+    return std::unique_ptr<T[], PoolRelease>((T*)FramePool::Acquire(bytes), PoolRelease{bytes});
+}
+
+template class BasicIntegralImage<unsigned int>;
+template class BasicIntegralImage<unsigned long long>;
+
+void boxFilter(ConstImageView src, ImageView dst, int radius, ThreadPool& pool)
+{
+    // 32 bit entries are exact for boxes up to 16.8M pixels (a radius of 2047)
+    if (radius < 2048)
+        boxMeans(IntegralImage32(src, false, pool), dst, radius, pool);
+    else
+        boxMeans(IntegralImage64(src, false, pool), dst, radius, pool);
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <FramePool.h>
+#include <ImageView.h>
+#include <Simd.h>
+#include <ThreadPool.h>
+
+#include <algorithm>
+#include <memory>
+
+// Summed-area table of a one channel 8 bit image: entry (x, y) holds the sum of every
+// pixel above and left of it, so any rectangle sums with 4 lookups whatever its size.
+// The table is (width + 1) x (height + 1) with a zero first row and column, which
+// keeps the queries free of edge cases. Squared pixel sums are kept alongside on
+// request, for variances.
+//
+// Sums wrap around in T. Rectangle sums are differences, so they stay exact as long as
+// the rectangle itself fits: with 32 bit entries that is up to 16.8M pixels for sums
+// and 66049 (257 x 257) for squared sums, however big the image. 64 bit entries are
+// exact for any image.
+//
+// Built in three passes: bands of rows are scanned in parallel, each as if it were the
+// top of the image (SIMD prefix sums along the row plus the row above). Then the last
+// row of every band gets the one of the band above added, top down on one thread, and
+// finally the other rows of every band add the finished last row above them, in parallel.
+//
+// The tables come from the FramePool, so they start on a cache line and are recycled
+// like frames.
+template <typename T>
+class BasicIntegralImage
+{
+    private:
+        // Hands a table back to the FramePool
+        struct PoolRelease
+        {
+            size_t bytes;
+            void operator()(T* table) const { FramePool::Release((unsigned char*)table, bytes); }
+        };
+
+        int m_Width, m_Height;
+        // Entries from one row to the next, width + 1 rounded up to whole cache lines, so
+        // every row starts on one
+        int m_Stride;
+        // (height + 1) * m_Stride entries each, kept across Build() calls of the same size
+        size_t m_Capacity;
+        std::unique_ptr<T[], PoolRelease> m_Sums;
+        // Null unless asked for
+        std::unique_ptr<T[], PoolRelease> m_Squares;
+    public:
+        BasicIntegralImage();
+        explicit BasicIntegralImage(ConstImageView src, bool squares = false, ThreadPool& pool = ThreadPool::Global());
+
+        void Build(ConstImageView src, bool squares = false, ThreadPool& pool = ThreadPool::Global());
+
+        // Same, forcing a specific implementation (falls back to the best supported one)
+        void Build(ConstImageView src, bool squares, ThreadPool& pool, SimdLevel level);
+
+        // Sum of the pixels in [x, x + width) x [y, y + height), which must lie inside the image
+        inline T Sum(int x, int y, int width, int height) const
+        {
+            return Rectangle(m_Sums.get(), x, y, width, height);
+        }
+
+        // Sum of the squared pixels of the same rectangle, needs the squared table
+        inline T SquareSum(int x, int y, int width, int height) const
+        {
+            return Rectangle(m_Squares.get(), x, y, width, height);
+        }
+
+        inline double Mean(int x, int y, int width, int height) const
+        {
+            return (double)Sum(x, y, width, height) / ((double)width * height);
+        }
+
+        // Population variance of the rectangle's pixels, needs the squared table
+        inline double Variance(int x, int y, int width, int height) const
+        {
+            const double count = (double)width * height;
+            const double mean = (double)Sum(x, y, width, height) / count;
+            return std::max(0.0, (double)SquareSum(x, y, width, height) / count - mean * mean);
+        }
+
+        // Entry (x, y) for x in [0, width] and y in [0, height]
+        inline T At(int x, int y) const { return m_Sums[(size_t)y * m_Stride + x]; }
+        inline T SquareAt(int x, int y) const { return m_Squares[(size_t)y * m_Stride + x]; }
+
+        inline int GetWidth() const { return m_Width; }
+        inline int GetHeight() const { return m_Height; }
+        inline bool HasSquares() const { return (bool)m_Squares; }
+        inline bool IsEmpty() const { return !m_Sums; }
+    private:
+        static std::unique_ptr<T[], PoolRelease> AllocateTable(size_t size);
+
+        inline T Rectangle(const T* table, int x, int y, int width, int height) const
+        {
+            const T* top = table + (size_t)y * m_Stride;
+            const T* bottom = table + (size_t)(y + height) * m_Stride;
+            return bottom[x + width] - bottom[x] - top[x + width] + top[x];
+        }
+};
+
+typedef BasicIntegralImage<unsigned int> IntegralImage32;
+typedef BasicIntegralImage<unsigned long long> IntegralImage64;
+
+// Mean of the (2 * radius + 1)^2 box around every pixel, rounded to nearest. The box is
+// clipped at the frame edge and averages only the pixels inside. O(1) per pixel for any
+// radius. 'dst' may alias 'src'.
+void boxFilter(ConstImageView src, ImageView dst, int radius, ThreadPool& pool = ThreadPool::Global());
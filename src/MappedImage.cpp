@@ -0,0 +1,341 @@
+#include <MappedImage.h>
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace
+{
+    struct RawHeader
+    {
+        int width = 0, height = 0, channels = 0, maxval = 0;
+        size_t payloadOffset = 0;
+    };
+
+    // Reads header tokens out of the mapped bytes, skipping whitespace and # comments
+    class HeaderParser
+    {
+        private:
+            const unsigned char* m_Data;
+            size_t m_Size, m_Position;
+        public:
+            HeaderParser(const unsigned char* data, size_t size)
+                : m_Data(data), m_Size(size), m_Position(0) {}
+
+            std::string Next()
+            {
+                while (m_Position < m_Size && (std::isspace(m_Data[m_Position]) || m_Data[m_Position] == '#'))
+                {
+                    if (m_Data[m_Position] == '#')
+                    {
+                        while (m_Position < m_Size && m_Data[m_Position] != '\n')
+                            m_Position++;
+                    }
+                    else
+                    {
+                        m_Position++;
+                    }
+                }
+                std::string token;
+                while (m_Position < m_Size && !std::isspace(m_Data[m_Position]) && token.size() < 32)
+                    token += (char)m_Data[m_Position++];
+                return token;
+            }
+
+            int NextNumber()
+            {
+                const std::string token = Next();
+                if (token.empty() || token.size() > 9 || token.find_first_not_of("0123456789") != std::string::npos)
+                    return -1;
+                return std::atoi(token.c_str());
+            }
+
+            // Exactly one whitespace byte separates the header from the pixels
+            size_t EndOfHeader() const
+            {
+                return m_Position < m_Size ? m_Position + 1 : m_Size;
+            }
+    };
+
+    bool parseHeader(const unsigned char* data, size_t size, RawHeader& header)
+    {
+        if (size < 3 || data[0] != 'P')
+            return false;
+        HeaderParser parser(data, size);
+        const std::string magic = parser.Next();
+
+        if (magic == "P5" || magic == "P6")
+        {
+            header.width = parser.NextNumber();
+            header.height = parser.NextNumber();
+            header.maxval = parser.NextNumber();
+            header.channels = magic == "P5" ? 1 : 3;
+        }
+        else if (magic == "P7")
+        {
+            while (true)
+            {
+                const std::string key = parser.Next();
+                if (key.empty())
+                    return false;
+                if (key == "ENDHDR")
+                    break;
+                if (key == "TUPLTYPE")
+                    parser.Next();
+                else if (key == "WIDTH")
+                    header.width = parser.NextNumber();
+                else if (key == "HEIGHT")
+                    header.height = parser.NextNumber();
+                else if (key == "DEPTH")
+                    header.channels = parser.NextNumber();
+                else if (key == "MAXVAL")
+                    header.maxval = parser.NextNumber();
+                else
+                    return false;
+            }
+        }
+        else
+        {
+            return false;
+        }
+
+        // View() hands out the samples as they are, so they must already be on the 0..255
+        // scale: a smaller maxval would need a rescaling copy
+        header.payloadOffset = parser.EndOfHeader();
+        if (header.width <= 0 || header.height <= 0 || header.channels < 1 || header.channels > 4 ||
+            header.maxval != 255)
+            return false;
+        const size_t payload = (size_t)header.width * header.height * header.channels;
+        return header.payloadOffset + payload <= size;
+    }
+
+    const char* tupleType(int channels)
+    {
+        switch (channels)
+        {
+            case 1: return "GRAYSCALE";
+            case 2: return "GRAYSCALE_ALPHA";
+            case 3: return "RGB";
+            default: return "RGB_ALPHA";
+        }
+    }
+
+    // PAM header whose length is a multiple of kPayloadAlignment
+    std::string pamHeader(int width, int height, int channels)
+    {
+        std::string header = "P7\nWIDTH " + std::to_string(width) + "\nHEIGHT " + std::to_string(height) +
+                             "\nDEPTH " + std::to_string(channels) + "\nMAXVAL 255\nTUPLTYPE " +
+                             tupleType(channels) + "\n";
+        const std::string end = "ENDHDR\n";
+        // "#" + filler + "\n" pads up to the alignment
+        size_t length = header.size() + end.size() + 2;
+        const size_t alignment = MappedImage::kPayloadAlignment;
+        const size_t padded = (length + alignment - 1) / alignment * alignment;
+        header += "#" + std::string(padded - length, ' ') + "\n" + end;
+        return header;
+    }
+
+    // Maps 'size' bytes of the file (the whole file when 'create' is false and size is 0).
+    // 'size' returns the mapped length.
+    unsigned char* mapFile(const std::string& filepath, bool writable, bool create, size_t& size)
+    {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ | (writable ? GENERIC_WRITE : 0), FILE_SHARE_READ,
+                                  NULL, create ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+            return nullptr;
+        if (!create)
+        {
+            LARGE_INTEGER file_size;
+            if (!GetFileSizeEx(file, &file_size))
+            {
+                CloseHandle(file);
+                return nullptr;
+            }
+            size = (size_t)file_size.QuadPart;
+        }
+        if (size == 0)
+        {
+            CloseHandle(file);
+            return nullptr;
+        }
+        // A new file grows to the mapping's size
+        HANDLE mapping = CreateFileMappingA(file, NULL, writable ? PAGE_READWRITE : PAGE_READONLY,
+                                            (DWORD)((unsigned long long)size >> 32), (DWORD)(size & 0xFFFFFFFF), NULL);
+        CloseHandle(file);
+        if (!mapping)
+            return nullptr;
+        void* view = MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size);
+        // The view keeps the mapping alive
+        CloseHandle(mapping);
+        return (unsigned char*)view;
+#else
+        const int fd = open(filepath.c_str(), writable ? (O_RDWR | (create ? O_CREAT | O_TRUNC : 0)) : O_RDONLY, 0644);
+        if (fd < 0)
+            return nullptr;
+        if (create)
+        {
+            if (ftruncate(fd, (off_t)size) != 0)
+            {
+                close(fd);
+                return nullptr;
+            }
+        }
+        else
+        {
+            struct stat info;
+            if (fstat(fd, &info) != 0)
+            {
+                close(fd);
+                return nullptr;
+            }
+            size = (size_t)info.st_size;
+        }
+        if (size == 0)
+        {
+            close(fd);
+            return nullptr;
+        }
+        void* view = mmap(nullptr, size, PROT_READ | (writable ? PROT_WRITE : 0), MAP_SHARED, fd, 0);
+        // The mapping keeps the file open
+        close(fd);
+        return view == MAP_FAILED ? nullptr : (unsigned char*)view;
+#endif
+    }
+}
+
+MappedImage::MappedImage()
+    : m_Mapping(nullptr), m_MappingSize(0), m_PayloadOffset(0),
+      m_Width(0), m_Height(0), m_Channels(0), m_Writable(false)
+{
+}
+
+MappedImage::~MappedImage()
+{
+    Unmap();
+}
+
+MappedImage::MappedImage(MappedImage&& other) noexcept
+    : m_Mapping(other.m_Mapping), m_MappingSize(other.m_MappingSize), m_PayloadOffset(other.m_PayloadOffset),
+      m_Width(other.m_Width), m_Height(other.m_Height), m_Channels(other.m_Channels), m_Writable(other.m_Writable)
+{
+    other.m_Mapping = nullptr;
+    other.m_MappingSize = other.m_PayloadOffset = 0;
+    other.m_Width = other.m_Height = other.m_Channels = 0;
+    other.m_Writable = false;
+}
+
+MappedImage& MappedImage::operator=(MappedImage&& other) noexcept
+{
+    if (this != &other)
+    {
+        Unmap();
+        m_Mapping = other.m_Mapping;
+        m_MappingSize = other.m_MappingSize;
+        m_PayloadOffset = other.m_PayloadOffset;
+        m_Width = other.m_Width;
+        m_Height = other.m_Height;
+        m_Channels = other.m_Channels;
+        m_Writable = other.m_Writable;
+        other.m_Mapping = nullptr;
+        other.m_MappingSize = other.m_PayloadOffset = 0;
+        other.m_Width = other.m_Height = other.m_Channels = 0;
+        other.m_Writable = false;
+    }
+    return *this;
+}
+
+MappedImage MappedImage::Open(const std::string& filepath, bool writable)
+{
+    MappedImage image;
+    size_t size = 0;
+    image.m_Mapping = mapFile(filepath, writable, false, size);
+    if (!image.m_Mapping)
+        return MappedImage();
+    image.m_MappingSize = size;
+
+    RawHeader header;
+    if (!parseHeader(image.m_Mapping, size, header))
+        return MappedImage();
+
+    image.m_PayloadOffset = header.payloadOffset;
+    image.m_Width = header.width;
+    image.m_Height = header.height;
+    image.m_Channels = header.channels;
+    image.m_Writable = writable;
+    return image;
+}
+
+MappedImage MappedImage::Create(const std::string& filepath, int width, int height, int channels)
+{
+    if (width <= 0 || height <= 0 || channels < 1 || channels > 4)
+        return MappedImage();
+
+    // A new file reads back as zeros, only the header is written
+    const std::string header = pamHeader(width, height, channels);
+    MappedImage image;
+    size_t size = header.size() + (size_t)width * height * channels;
+    image.m_Mapping = mapFile(filepath, true, true, size);
+    if (!image.m_Mapping)
+        return MappedImage();
+    std::memcpy(image.m_Mapping, header.data(), header.size());
+
+    image.m_MappingSize = size;
+    image.m_PayloadOffset = header.size();
+    image.m_Width = width;
+    image.m_Height = height;
+    image.m_Channels = channels;
+    image.m_Writable = true;
+    return image;
+}
+
+bool MappedImage::Flush()
+{
+    if (!m_Mapping || !m_Writable)
+        return false;
+#ifdef _WIN32
+    return FlushViewOfFile(m_Mapping, m_MappingSize) != 0;
+#else
+    return msync(m_Mapping, m_MappingSize, MS_SYNC) == 0;
+#endif
+}
+
+void MappedImage::Unmap()
+{
+    if (!m_Mapping)
+        return;
+#ifdef _WIN32
+    UnmapViewOfFile(m_Mapping);
+#else
+    munmap(m_Mapping, m_MappingSize);
+#endif
+    m_Mapping = nullptr;
+}
+
+bool saveRawImage(const std::string& filepath, ConstImageView image)
+{
+    MappedImage file = MappedImage::Create(filepath, image.GetWidth(), image.GetHeight(), image.GetChannels());
+    if (file.IsEmpty())
+        return false;
+    copyPixels(image, file.View());
+    return true;
+}
+
+bool isPamFile(const std::string& filepath)
+{
+    std::ifstream file(filepath, std::ios::binary);
+    char magic[3] = {};
+    return file.read(magic, 3) && magic[0] == 'P' && magic[1] == '7' && std::isspace((unsigned char)magic[2]);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <ImageView.h>
+
+#include <cstddef>
+#include <string>
+
+// Raw 8 bit image file mapped into memory. Reads need no decode and no copy: View()
+// points straight at the file's pixels, and a writable mapping can be filtered in place.
+// Open() takes binary PGM (P5), PPM (P6) and PAM (P7). Create() writes a PAM whose
+// header is padded with a comment so the pixels start on a kPayloadAlignment byte
+// boundary; other PAM readers skip the comment. Rows are tightly packed, as the formats
+// require, and nothing follows the last row. Move-only; the mapping ends with the object.
+class MappedImage
+{
+    public:
+        static const int kPayloadAlignment = 64;
+    private:
+        unsigned char* m_Mapping;
+        size_t m_MappingSize;
+        size_t m_PayloadOffset;
+        int m_Width, m_Height, m_Channels;
+        bool m_Writable;
+    public:
+        MappedImage();
+        ~MappedImage();
+
+        MappedImage(MappedImage&& other) noexcept;
+        MappedImage& operator=(MappedImage&& other) noexcept;
+        MappedImage(const MappedImage&) = delete;
+        MappedImage& operator=(const MappedImage&) = delete;
+
+        // Maps an existing file, empty on failure or anything but 8 bit samples with a
+        // maxval of 255. Writes through a writable mapping change the file.
+        static MappedImage Open(const std::string& filepath, bool writable = false);
+
+        // Creates (or truncates) a width x height PAM and maps it writable, pixels zeroed
+        static MappedImage Create(const std::string& filepath, int width, int height, int channels);
+
+        // Pushes written pixels to the file now instead of whenever the OS gets to it
+        bool Flush();
+
+        // The view of a read-only mapping must not be written to
+        inline ImageView View() { return ImageView(GetData(), m_Width, m_Height, m_Channels); }
+        inline ConstImageView View() const { return ConstImageView(GetData(), m_Width, m_Height, m_Channels); }
+
+        inline unsigned char* GetData() { return m_Mapping ? m_Mapping + m_PayloadOffset : nullptr; }
+        inline const unsigned char* GetData() const { return m_Mapping ? m_Mapping + m_PayloadOffset : nullptr; }
+
+        inline int GetWidth() const { return m_Width; }
+        inline int GetHeight() const { return m_Height; }
+        inline int GetChannels() const { return m_Channels; }
+        inline bool IsWritable() const { return m_Writable; }
+        inline bool IsEmpty() const { return !m_Mapping; }
+    private:
+        void Unmap();
+};
+
+// Dumps any view as a PAM through a mapping, which costs about a memcpy of the pixels
+bool saveRawImage(const std::string& filepath, ConstImageView image);
+
+// True for a file starting with the PAM (P7) magic, which stb_image can't decode
+bool isPamFile(const std::string& filepath);
@@ -0,0 +1,143 @@
+#include <OffscreenContext.h>
+
+#include <glad/glad.h>
+
+#include <iostream>
+
+#if defined(__linux__)
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <cstring>
+
+namespace
+{
+    bool hasExtension(const char* extensions, const char* name)
+    {
+        const size_t length = std::strlen(name);
+        for (const char* at = extensions; at && (at = std::strstr(at, name)); at += length)
+        {
+            if ((at == extensions || at[-1] == ' ') && (at[length] == ' ' || at[length] == '\0'))
+                return true;
+        }
+        return false;
+    }
+
+    EGLDisplay openDisplay()
+    {
+        // Client extensions, queried without a display
+        const char* extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+        if (hasExtension(extensions, "EGL_MESA_platform_surfaceless"))
+        {
+            PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+                (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+            if (getPlatformDisplay)
+            {
+                EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+                if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr))
+                    return display;
+            }
+        }
+        EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr))
+            return display;
+        return EGL_NO_DISPLAY;
+    }
+}
+
+OffscreenContext::OffscreenContext()
+    : m_Display(nullptr), m_Context(nullptr)
+{
+}
+
+OffscreenContext::~OffscreenContext()
+{
+    if (m_Context)
+    {
+        eglMakeCurrent((EGLDisplay)m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext((EGLDisplay)m_Display, (EGLContext)m_Context);
+    }
+    if (m_Display)
+        eglTerminate((EGLDisplay)m_Display);
+}
+
+bool OffscreenContext::Create()
+{
+    EGLDisplay display = openDisplay();
+    if (display == EGL_NO_DISPLAY)
+    {
+        std::cout << "[EGL] no display" << std::endl;
+        return false;
+    }
+    m_Display = display;
+
+    if (!hasExtension(eglQueryString(display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context"))
+    {
+        std::cout << "[EGL] EGL_KHR_surfaceless_context is not supported" << std::endl;
+        return false;
+    }
+    if (!eglBindAPI(EGL_OPENGL_API))
+    {
+        std::cout << "[EGL] desktop OpenGL is not supported" << std::endl;
+        return false;
+    }
+
+    // No surface is ever created, any config that renders desktop GL will do. The surface
+    // type defaults to windows, which the surfaceless platform has none of.
+    const EGLint config_attributes[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint configs = 0;
+    if (!eglChooseConfig(display, config_attributes, &config, 1, &configs) || configs == 0)
+    {
+        std::cout << "[EGL] no OpenGL config" << std::endl;
+        return false;
+    }
+
+    /* Same version and profile as the window */
+    const EGLint context_attributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, context_attributes);
+    if (context == EGL_NO_CONTEXT)
+    {
+        std::cout << "[EGL] can't create an OpenGL 3.3 core context (" << std::hex << eglGetError() << std::dec << ")" << std::endl;
+        return false;
+    }
+    if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context) ||
+        !gladLoadGLLoader((GLADloadproc)eglGetProcAddress))
+    {
+        std::cout << "[EGL] can't make the context current" << std::endl;
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(display, context);
+        return false;
+    }
+    m_Context = context;
+    return true;
+}
+
+#else
+
+OffscreenContext::OffscreenContext()
+    : m_Display(nullptr), m_Context(nullptr)
+{
+}
+
+OffscreenContext::~OffscreenContext()
+{
+}
+
+bool OffscreenContext::Create()
+{
+    std::cout << "Offscreen rendering needs EGL, which is only used on Linux" << std::endl;
+    return false;
+}
+
+#endif
@@ -0,0 +1,23 @@
+#pragma once
+
+// OpenGL 3.3 core context without a window or a display server: EGL on Mesa's surfaceless
+// platform (llvmpipe stands in when there is no GPU), falling back to the default EGL
+// display. There is no default framebuffer, draw into a Framebuffer. Create() makes the
+// context current and loads glad through eglGetProcAddress. Linux only, Create() fails
+// on other systems.
+class OffscreenContext
+{
+    private:
+        void* m_Display;
+        void* m_Context;
+    public:
+        OffscreenContext();
+        ~OffscreenContext();
+
+        OffscreenContext(const OffscreenContext&) = delete;
+        OffscreenContext& operator=(const OffscreenContext&) = delete;
+
+        bool Create();
+
+        inline bool IsValid() const { return m_Context != nullptr; }
+};
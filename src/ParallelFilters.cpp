@@ -0,0 +1,152 @@
+#include <ParallelFilters.h>
+#include <ColorConvert.h>
+#include <HysteresisEngine.h>
+#include <RecursiveGaussian.h>
+#include <Resample.h>
+
+#include <cstring>
+
+// Runs an in-place full-frame filter tile by tile and writes the result back in place
+static void runInPlace(unsigned char* image, int width, int height, int halo, TileExecutor& executor,
+                       const std::function<void(unsigned char*, int, int)>& filter)
+{
+    Image new_image(width, height, 1);
+    executor.Run(ConstImageView(image, width, height), new_image.View(), halo, filter);
+    copyPixels(new_image.View(), ImageView(image, width, height));
+}
+
+void noiseTiled(unsigned char *image, int width, int height, TileExecutor& executor)
+{
+    runInPlace(image, width, height, 1, executor, [](unsigned char* tile, int w, int h)
+    {
+        noise(tile, w, h, w * h);
+    });
+}
+
+std::vector<unsigned char> gradientCalculationTiled(unsigned char *image, int width, int height, TileExecutor& executor,
+                                                    GradientNorm norm)
+{
+    Image new_image(width, height, 1);
+    std::vector<unsigned char> directions((size_t)width * height);
+
+    executor.ForEachTile(width, height, 1, [&](const Tile& tile)
+    {
+        const size_t size = (size_t)tile.padWidth * tile.padHeight;
+        unsigned char* buffer = TileExecutor::Scratch(size);
+        unsigned char* magnitude = TileExecutor::Scratch(size, 1);
+        unsigned char* tile_directions = TileExecutor::Scratch(size, 2);
+        TileExecutor::CopyTileIn(image, width, tile, buffer);
+        gradientCalculation(ConstImageView(buffer, tile.padWidth, tile.padHeight),
+                            ImageView(magnitude, tile.padWidth, tile.padHeight),
+                            ImageView(tile_directions, tile.padWidth, tile.padHeight), norm);
+        TileExecutor::CopyTileOut(magnitude, tile, new_image.GetData(), new_image.GetStride());
+        TileExecutor::CopyTileOut(tile_directions, tile, directions.data(), width);
+    });
+
+    copyPixels(new_image.View(), ImageView(image, width, height));
+    return directions;
+}
+
+void Non_MaxSuppressionTiled(unsigned char *image, int width, int height, const std::vector<unsigned char>& directions,
+                             TileExecutor& executor)
+{
+    Image new_image(width, height, 1);
+
+    executor.ForEachTile(width, height, 1, [&](const Tile& tile)
+    {
+        const size_t size = (size_t)tile.padWidth * tile.padHeight;
+        unsigned char* buffer = TileExecutor::Scratch(size);
+        unsigned char* tile_directions = TileExecutor::Scratch(size, 1);
+        unsigned char* suppressed = TileExecutor::Scratch(size, 2);
+        TileExecutor::CopyTileIn(image, width, tile, buffer);
+        TileExecutor::CopyTileIn(directions.data(), width, tile, tile_directions);
+        Non_MaxSuppression(ConstImageView(buffer, tile.padWidth, tile.padHeight),
+                           ConstImageView(tile_directions, tile.padWidth, tile.padHeight),
+                           ImageView(suppressed, tile.padWidth, tile.padHeight));
+        TileExecutor::CopyTileOut(suppressed, tile, new_image.GetData(), new_image.GetStride());
+    });
+
+    copyPixels(new_image.View(), ImageView(image, width, height));
+}
+
+void ThresholdingTiled(unsigned char *img, int width, int height, TileExecutor& executor)
+{
+    // Per pixel, rows can be processed in place
+    executor.GetPool().ParallelRanges(height, 16, [&](int first, int last)
+    {
+        Thresholding(img + (size_t)first * width, width, last - first);
+    });
+}
+
+void HysteresisTiled(unsigned char *image, int width, int height, TileExecutor& executor)
+{
+    runInPlace(image, width, height, 1, executor, [](unsigned char* tile, int w, int h)
+    {
+        Hysteresis(tile, w, h, w * h);
+    });
+}
+
+void cannyTiled(ConstImageView src, ImageView dst, TileExecutor& executor, const CannyParams& params)
+{
+    // Connected hysteresis is not local, tiles stop at the edge map and the tracing
+    // runs over the whole frame with the parallel union-find
+    CannyParams tile_params = params;
+    if (params.hysteresis == HysteresisMode::Connected)
+        tile_params.hysteresis = HysteresisMode::None;
+
+    // Neither is the recursive blur, its reach has no fixed halo. The tiles start from
+    // the whole frame blurred on the same pool.
+    Image blurred;
+    if (params.blur == CannyBlur::Recursive)
+    {
+        blurred = Image(src.GetWidth(), src.GetHeight(), 1);
+        recursiveGaussian(src, blurred.View(), params.sigma, executor.GetPool());
+        src = blurred.View();
+        tile_params.blur = CannyBlur::None;
+    }
+
+    executor.Run(src, dst, 4, [&](unsigned char* tile, int w, int h)
+    {
+        CannyEngine engine(w, tile_params);
+        engine.Process(tile, tile, h);
+    });
+
+    if (params.hysteresis == HysteresisMode::Connected)
+        hysteresisUnionFind(dst.GetData(), dst.GetData(), dst.GetWidth(), dst.GetHeight(), executor, dst.GetStride());
+}
+
+void cannyTiled(unsigned char *image, int width, int height, TileExecutor& executor, const CannyParams& params)
+{
+    Image new_image(width, height, 1);
+    cannyTiled(ConstImageView(image, width, height), new_image.View(), executor, params);
+    copyPixels(new_image.View(), ImageView(image, width, height));
+}
+
+unsigned char * haftoneTiled(unsigned char * image, int width, int height, TileExecutor& executor)
+{
+    unsigned char * new_image = new unsigned char[(size_t)width * height * 4];
+
+    // Every source row expands into two full output rows, so bands stay contiguous
+    executor.GetPool().ParallelRanges(height, 16, [&](int first, int last)
+    {
+        unsigned char * band = haftone(image + (size_t)first * width, width, last - first);
+        std::memcpy(new_image + (size_t)first * width * 4, band, (size_t)(last - first) * width * 4);
+        delete [] band;
+    });
+    return new_image;
+}
+
+void compressImageTiled(const unsigned char* old_Image, unsigned char* new_Image, TileExecutor& executor)
+{
+    areaResample(old_Image, 512, 512, 0, new_Image, 256, 256, 0, 1, executor.GetPool());
+}
+
+unsigned char * GrayscaleTiled(unsigned char * image, int length, TileExecutor& executor)
+{
+    unsigned char * new_image = new unsigned char[length];
+    executor.GetPool().ParallelRanges(length, 1 << 16, [&](int first, int last)
+    {
+        lumaRow(image + (size_t)first * 4, PixelFormat::RGBA, new_image + first, last - first);
+    });
+    return new_image;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <CannyEngine.h>
+#include <Filters.h>
+#include <TileExecutor.h>
+
+#include <vector>
+
+// Multithreaded versions of the stages in Filters.h. Each one splits the frame into
+// tiles (halo = the stage's neighbourhood radius) or row bands and produces exactly
+// the same output as its serial counterpart.
+
+void noiseTiled(unsigned char *image, int width, int height, TileExecutor& executor);
+std::vector<unsigned char> gradientCalculationTiled(unsigned char *image, int width, int height, TileExecutor& executor,
+                                                    GradientNorm norm = GradientNorm::L2);
+void Non_MaxSuppressionTiled(unsigned char *image, int width, int height, const std::vector<unsigned char>& directions,
+                             TileExecutor& executor);
+void ThresholdingTiled(unsigned char *img, int width, int height, TileExecutor& executor);
+void HysteresisTiled(unsigned char *image, int width, int height, TileExecutor& executor);
+
+// Whole Canny chain per tile, the halo covers the 4 chained 3x3 neighbourhoods.
+// Connected hysteresis is finished with hysteresisUnionFind() over the full frame and
+// the recursive blur runs over the full frame before the tiles.
+void cannyTiled(unsigned char *image, int width, int height, TileExecutor& executor,
+                const CannyParams& params = CannyParams());
+// Same from 'src' into 'dst' (same size, must not alias), without the copy back
+void cannyTiled(ConstImageView src, ImageView dst, TileExecutor& executor,
+                const CannyParams& params = CannyParams());
+
+unsigned char * haftoneTiled(unsigned char * image, int width, int height, TileExecutor& executor);
+void compressImageTiled(const unsigned char* old_Image, unsigned char* new_Image, TileExecutor& executor);
+unsigned char * GrayscaleTiled(unsigned char * image, int length, TileExecutor& executor);
@@ -0,0 +1,21 @@
+#pragma once
+
+enum class PixelFormat
+{
+    Gray,       // 1 byte per pixel
+    GrayAlpha,  // 2 bytes per pixel, grey then alpha
+    RGB,        // 3 bytes per pixel
+    RGBA,       // 4 bytes per pixel, what stbi_load(..., 4) returns
+    BGRA        // 4 bytes per pixel, common for captures and windowing systems
+};
+
+inline int bytesPerPixel(PixelFormat format)
+{
+    switch (format)
+    {
+        case PixelFormat::Gray: return 1;
+        case PixelFormat::GrayAlpha: return 2;
+        case PixelFormat::RGB: return 3;
+        default: return 4;
+    }
+}
@@ -0,0 +1,60 @@
+#include <PixelReadback.h>
+
+#include <cstring>
+
+PixelReadback::PixelReadback(int width, int height)
+    : m_BufferID(0), m_Fence(nullptr), m_Width(width), m_Height(height)
+{
+    GLCall(glGenBuffers(1, &m_BufferID));
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, m_BufferID));
+    GLCall(glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)width * height * 4, nullptr, GL_STREAM_READ));
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+}
+
+PixelReadback::~PixelReadback()
+{
+    if (m_Fence)
+        glDeleteSync(m_Fence);
+    GLCall(glDeleteBuffers(1, &m_BufferID));
+}
+
+void PixelReadback::Start()
+{
+    if (m_Fence)
+        glDeleteSync(m_Fence);
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, m_BufferID));
+    GLCall(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+    // With a pack buffer bound the last argument is an offset into it, nothing is waited for here
+    GLCall(glReadPixels(0, 0, m_Width, m_Height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+    m_Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+}
+
+bool PixelReadback::IsReady()
+{
+    return m_Fence && glClientWaitSync(m_Fence, 0, 0) != GL_TIMEOUT_EXPIRED;
+}
+
+Image PixelReadback::Finish()
+{
+    if (!m_Fence)
+        return Image();
+    while (glClientWaitSync(m_Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED);
+    glDeleteSync(m_Fence);
+    m_Fence = nullptr;
+
+    Image image(m_Width, m_Height, 4);
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, m_BufferID));
+    GLCall(const unsigned char* pixels = (const unsigned char*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+                                                                                  (GLsizeiptr)m_Width * m_Height * 4, GL_MAP_READ_BIT));
+    if (pixels)
+    {
+        // GL rows start at the bottom
+        for (int y = 0; y < m_Height; y++)
+            std::memcpy(image.GetRow(y), pixels + (size_t)(m_Height - 1 - y) * m_Width * 4, (size_t)m_Width * 4);
+        GLCall(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+    }
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+    return pixels ? std::move(image) : Image();
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <Debugger.h>
+#include <Image.h>
+
+// Reads the bound framebuffer back through a pixel pack buffer. Start() only queues the
+// copy, so the GPU fills the buffer while the CPU goes on with other work; Finish()
+// waits on a fence and maps the buffer. The buffer can be started again afterwards.
+class PixelReadback
+{
+    private:
+        unsigned int m_BufferID;
+        GLsync m_Fence;
+        int m_Width, m_Height;
+    public:
+        PixelReadback(int width, int height);
+        ~PixelReadback();
+
+        PixelReadback(const PixelReadback&) = delete;
+        PixelReadback& operator=(const PixelReadback&) = delete;
+
+        // Queues a copy of the lower left width x height pixels of the read framebuffer
+        void Start();
+
+        // True once the copy of the last Start() has landed (doesn't block)
+        bool IsReady();
+
+        // RGBA, top row first. Empty when nothing was started.
+        Image Finish();
+};
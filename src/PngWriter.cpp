@@ -0,0 +1,289 @@
+#include <PngWriter.h>
+#include <Deflate.h>
+#include <Profiler.h>
+#include <Simd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+
+namespace
+{
+    enum RowFilter
+    {
+        kFilterNone, kFilterSub, kFilterUp, kFilterAverage, kFilterPaeth, kFilterCount
+    };
+
+    inline unsigned char paethPredictor(int a, int b, int c)
+    {
+        const int pa = std::abs(b - c), pb = std::abs(a - c), pc = std::abs(a + b - 2 * c);
+        if (pa <= pb && pa <= pc)
+            return (unsigned char)a;
+        return (unsigned char)(pb <= pc ? b : c);
+    }
+
+    // out[i] = row[i] - predictor, bytes left of the row and the row above the first count as 0
+    void filterScalar(int filter, const unsigned char* row, const unsigned char* prior, int bpp,
+                      int from, int to, unsigned char* out)
+    {
+        for (int i = from; i < to; i++)
+        {
+            const int a = i >= bpp ? row[i - bpp] : 0;
+            const int b = prior[i];
+            const int c = i >= bpp ? prior[i - bpp] : 0;
+            int predictor = 0;
+            switch (filter)
+            {
+                case kFilterSub: predictor = a; break;
+                case kFilterUp: predictor = b; break;
+                case kFilterAverage: predictor = (a + b) >> 1; break;
+                case kFilterPaeth: predictor = paethPredictor(a, b, c); break;
+                default: break;
+            }
+            out[i] = (unsigned char)(row[i] - predictor);
+        }
+    }
+
+#if defined(GRAPHICS_SSE2)
+    inline __m128i abs16(__m128i x)
+    {
+        return _mm_max_epi16(x, _mm_sub_epi16(_mm_setzero_si128(), x));
+    }
+
+    // Paeth predictor of 8 pixels held in 16 bit lanes
+    inline __m128i paeth16(__m128i a, __m128i b, __m128i c)
+    {
+        const __m128i pa = abs16(_mm_sub_epi16(b, c));
+        const __m128i pb = abs16(_mm_sub_epi16(a, c));
+        const __m128i pc = abs16(_mm_add_epi16(_mm_sub_epi16(a, c), _mm_sub_epi16(b, c)));
+        const __m128i not_a = _mm_or_si128(_mm_cmpgt_epi16(pa, pb), _mm_cmpgt_epi16(pa, pc));
+        const __m128i take_c = _mm_cmpgt_epi16(pb, pc);
+        const __m128i b_or_c = _mm_or_si128(_mm_and_si128(take_c, c), _mm_andnot_si128(take_c, b));
+        return _mm_or_si128(_mm_and_si128(not_a, b_or_c), _mm_andnot_si128(not_a, a));
+    }
+
+    // The bytes from 'bpp' on, 16 at a time: nothing depends on an earlier output, every
+    // predictor reads the unfiltered bytes
+    int filterSSE2(int filter, const unsigned char* row, const unsigned char* prior, int bpp, int length,
+                   unsigned char* out)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        int i = bpp;
+        for (; i + 16 <= length; i += 16)
+        {
+            const __m128i x = _mm_loadu_si128((const __m128i*)(row + i));
+            const __m128i a = _mm_loadu_si128((const __m128i*)(row + i - bpp));
+            const __m128i b = _mm_loadu_si128((const __m128i*)(prior + i));
+            __m128i predictor;
+            switch (filter)
+            {
+                case kFilterSub:
+                    predictor = a;
+                    break;
+                case kFilterUp:
+                    predictor = b;
+                    break;
+                case kFilterAverage:
+                    // _mm_avg_epu8 rounds up, take the odd sums back down
+                    predictor = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi8(1)));
+                    break;
+                case kFilterPaeth:
+                {
+                    const __m128i c = _mm_loadu_si128((const __m128i*)(prior + i - bpp));
+                    const __m128i lo = paeth16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero), _mm_unpacklo_epi8(c, zero));
+                    const __m128i hi = paeth16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero), _mm_unpackhi_epi8(c, zero));
+                    predictor = _mm_packus_epi16(lo, hi);
+                    break;
+                }
+                default:
+                    predictor = zero;
+                    break;
+            }
+            _mm_storeu_si128((__m128i*)(out + i), _mm_sub_epi8(x, predictor));
+        }
+        return i;
+    }
+
+    // Sum of |byte| with bytes read as signed, the usual heuristic for picking a filter
+    unsigned long long scoreSSE2(const unsigned char* data, int length, int& done)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i sum = zero;
+        int i = 0;
+        for (; i + 16 <= length; i += 16)
+        {
+            const __m128i v = _mm_loadu_si128((const __m128i*)(data + i));
+            sum = _mm_add_epi64(sum, _mm_sad_epu8(_mm_min_epu8(v, _mm_sub_epi8(zero, v)), zero));
+        }
+        done = i;
+        return (unsigned long long)_mm_cvtsi128_si32(sum) + (unsigned long long)_mm_cvtsi128_si32(_mm_srli_si128(sum, 8));
+    }
+#endif
+
+    void filterRow(int filter, const unsigned char* row, const unsigned char* prior, int bpp, int length,
+                   unsigned char* out)
+    {
+        if (filter == kFilterNone)
+        {
+            std::copy(row, row + length, out);
+            return;
+        }
+        int done = 0;
+#if defined(GRAPHICS_SSE2)
+        if (length > bpp)
+        {
+            filterScalar(filter, row, prior, bpp, 0, bpp, out);
+            done = filterSSE2(filter, row, prior, bpp, length, out);
+        }
+#endif
+        filterScalar(filter, row, prior, bpp, done, length, out);
+    }
+
+    unsigned long long scoreRow(const unsigned char* data, int length)
+    {
+        unsigned long long score = 0;
+        int i = 0;
+#if defined(GRAPHICS_SSE2)
+        score = scoreSSE2(data, length, i);
+#endif
+        for (; i < length; i++)
+            score += data[i] < 128 ? data[i] : 256 - data[i];
+        return score;
+    }
+
+    void putBigEndian(std::vector<unsigned char>& out, unsigned int value)
+    {
+        const unsigned char bytes[4] = {(unsigned char)(value >> 24), (unsigned char)(value >> 16),
+                                        (unsigned char)(value >> 8), (unsigned char)value};
+        out.insert(out.end(), bytes, bytes + 4);
+    }
+
+    void putChunk(std::vector<unsigned char>& out, const char* type, const unsigned char* data, size_t length)
+    {
+        putBigEndian(out, (unsigned int)length);
+        const size_t start = out.size();
+        out.insert(out.end(), type, type + 4);
+        out.insert(out.end(), data, data + length);
+        putBigEndian(out, crc32(out.data() + start, length + 4));
+    }
+}
+
+bool encodePng(ConstImageView image, std::vector<unsigned char>& out, const PngOptions& options, ThreadPool& pool)
+{
+    const int width = image.GetWidth(), height = image.GetHeight(), channels = image.GetChannels();
+    if (width <= 0 || height <= 0 || channels < 1 || channels > 4)
+        return false;
+    const int level = std::min(std::max(options.level, 0), 9);
+    const int row_bytes = width * channels;
+    const size_t line = (size_t)row_bytes + 1;     // filter byte + pixels
+
+    // Filter every row into one buffer, the deflate strips read each other's tails
+    PROFILE_SCOPE("encodePng");
+    std::vector<unsigned char> filtered(line * height);
+    const std::vector<unsigned char> zeros(row_bytes, 0);
+    pool.ParallelRanges(height, std::max(1, (1 << 16) / row_bytes), [&](int first, int last)
+    {
+        PROFILE_SCOPE("png filter rows");
+        std::vector<unsigned char> candidates(level > 0 ? (size_t)kFilterCount * row_bytes : 0);
+        for (int y = first; y < last; y++)
+        {
+            const unsigned char* row = image.GetRow(y);
+            const unsigned char* prior = y > 0 ? image.GetRow(y - 1) : zeros.data();
+            unsigned char* dst = filtered.data() + (size_t)y * line;
+            if (level == 0)
+            {
+                dst[0] = kFilterNone;
+                std::copy(row, row + row_bytes, dst + 1);
+                continue;
+            }
+
+            int best = kFilterNone;
+            unsigned long long best_score = ~0ull;
+            for (int filter = kFilterNone; filter < kFilterCount; filter++)
+            {
+                unsigned char* candidate = candidates.data() + (size_t)filter * row_bytes;
+                filterRow(filter, row, prior, channels, row_bytes, candidate);
+                const unsigned long long score = scoreRow(candidate, row_bytes);
+                if (score < best_score)
+                {
+                    best_score = score;
+                    best = filter;
+                }
+            }
+            dst[0] = (unsigned char)best;
+            const unsigned char* chosen = candidates.data() + (size_t)best * row_bytes;
+            std::copy(chosen, chosen + row_bytes, dst + 1);
+        }
+    });
+
+    int strip_rows = options.stripRows > 0 ? options.stripRows : std::max(1, (int)((256 << 10) / line));
+    strip_rows = std::min(strip_rows, height);
+    const int strips = (height + strip_rows - 1) / strip_rows;
+
+    // IDAT payloads: strip 0 leads with the zlib header, the last one gets the adler32
+    std::vector<std::vector<unsigned char>> payloads(strips);
+    std::vector<unsigned int> adlers(strips);
+    std::vector<unsigned int> crcs(strips);
+    pool.ParallelFor(strips, [&](int strip)
+    {
+        PROFILE_SCOPE("png deflate strip");
+        const size_t begin = (size_t)strip * strip_rows * line;
+        const size_t end = std::min((size_t)(strip + 1) * strip_rows, (size_t)height) * line;
+        std::vector<unsigned char>& payload = payloads[strip];
+        payload.reserve((end - begin) / (level == 0 ? 1 : 2) + 64);
+        if (strip == 0)
+        {
+            // CMF: deflate, 32 KB window. FLG carries the level class and makes the pair a multiple of 31.
+            const int level_class = level <= 1 ? 0 : level <= 5 ? 1 : level == 6 ? 2 : 3;
+            const unsigned int header = (0x78 << 8) | (level_class << 6);
+            payload.push_back(0x78);
+            payload.push_back((unsigned char)((header + (31 - header % 31) % 31) & 0xFF));
+        }
+        deflateStrip(filtered.data(), begin, end, level, strip == strips - 1, payload);
+        adlers[strip] = adler32(filtered.data() + begin, end - begin);
+        crcs[strip] = crc32(payload.data(), payload.size(), crc32((const unsigned char*)"IDAT", 4));
+    });
+
+    unsigned int adler = 1;
+    for (int strip = 0; strip < strips; strip++)
+    {
+        const size_t length = std::min((size_t)(strip + 1) * strip_rows, (size_t)height) * line - (size_t)strip * strip_rows * line;
+        adler = adler32Combine(adler, adlers[strip], length);
+    }
+    putBigEndian(payloads.back(), adler);
+    crcs.back() = crc32(payloads.back().data() + payloads.back().size() - 4, 4, crcs.back());
+
+    static const unsigned char kSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    static const unsigned char kColourType[5] = {0, 0, 4, 2, 6};   // grey, grey + alpha, RGB, RGBA
+    out.clear();
+    out.insert(out.end(), kSignature, kSignature + 8);
+
+    std::vector<unsigned char> header;
+    putBigEndian(header, (unsigned int)width);
+    putBigEndian(header, (unsigned int)height);
+    const unsigned char rest[5] = {8, kColourType[channels], 0, 0, 0};
+    header.insert(header.end(), rest, rest + 5);
+    putChunk(out, "IHDR", header.data(), header.size());
+
+    // IDAT checksums were taken on the strip threads
+    for (int strip = 0; strip < strips; strip++)
+    {
+        putBigEndian(out, (unsigned int)payloads[strip].size());
+        out.insert(out.end(), {'I', 'D', 'A', 'T'});
+        out.insert(out.end(), payloads[strip].begin(), payloads[strip].end());
+        putBigEndian(out, crcs[strip]);
+        std::vector<unsigned char>().swap(payloads[strip]);
+    }
+    putChunk(out, "IEND", nullptr, 0);
+    return true;
+}
+
+bool writePng(const std::string& filepath, ConstImageView image, const PngOptions& options, ThreadPool& pool)
+{
+    std::vector<unsigned char> encoded;
+    if (!encodePng(image, encoded, options, pool))
+        return false;
+    std::ofstream file(filepath, std::ios::binary);
+    file.write((const char*)encoded.data(), (std::streamsize)encoded.size());
+    return (bool)file;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <ImageView.h>
+#include <ThreadPool.h>
+
+#include <string>
+#include <vector>
+
+struct PngOptions
+{
+    // 0 stores the pixels uncompressed (fastest, meant for intermediates), 1 is the fast
+    // level, 9 the smallest output. 3 is about as fast as stb_image_write on one core and
+    // a third smaller; the lazy matching levels from 4 on cost far more time than they save bytes.
+    int level = 3;
+
+    // Rows per strip deflated on its own, 0 picks strips of about 256 KB
+    int stripRows = 0;
+};
+
+// PNG encoder for 8 bit images with 1 to 4 channels. Every row gets the filter
+// (None, Sub, Up, Average or Paeth) with the smallest sum of absolute values, scored with
+// SSE2. Strips of rows are deflated in parallel, each one primed with the 32 KB before it,
+// and joined into one zlib stream; every strip goes out as its own IDAT chunk.
+bool encodePng(ConstImageView image, std::vector<unsigned char>& out,
+               const PngOptions& options = PngOptions(), ThreadPool& pool = ThreadPool::Global());
+
+// encodePng() into a file, false on failure
+bool writePng(const std::string& filepath, ConstImageView image,
+              const PngOptions& options = PngOptions(), ThreadPool& pool = ThreadPool::Global());
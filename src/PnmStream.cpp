@@ -0,0 +1,146 @@
+#include <PnmStream.h>
+
+#include <cctype>
+
+namespace
+{
+    // Next header number, skipping whitespace and # comments. -1 on a malformed header.
+    int readHeaderValue(std::ifstream& file)
+    {
+        int c = file.get();
+        while (c != EOF && (std::isspace(c) || c == '#'))
+        {
+            if (c == '#')
+            {
+                while (c != EOF && c != '\n')
+                    c = file.get();
+            }
+            c = file.get();
+        }
+        if (c == EOF || !std::isdigit(c))
+            return -1;
+
+        long long value = 0;
+        while (c != EOF && std::isdigit(c))
+        {
+            value = value * 10 + (c - '0');
+            if (value > (1 << 30))
+                return -1;
+            c = file.get();
+        }
+        // Exactly one whitespace byte ends the header's last value, the pixels follow it
+        if (c != EOF && !std::isspace(c))
+            return -1;
+        return (int)value;
+    }
+}
+
+PnmReader::PnmReader()
+    : m_Width(0), m_Height(0), m_Channels(0), m_RowsRead(0), m_Maxval(255), m_Scale{}
+{
+}
+
+bool PnmReader::Open(const std::string& filepath)
+{
+    m_File.open(filepath, std::ios::binary);
+    if (!m_File)
+        return false;
+
+    char magic[2];
+    if (!m_File.read(magic, 2) || magic[0] != 'P' || (magic[1] != '5' && magic[1] != '6'))
+        return false;
+
+    const int width = readHeaderValue(m_File);
+    const int height = readHeaderValue(m_File);
+    const int maxval = readHeaderValue(m_File);
+    if (width <= 0 || height <= 0 || maxval <= 0 || maxval > 255)
+        return false;
+
+    m_Width = width;
+    m_Height = height;
+    m_Channels = magic[1] == '5' ? 1 : 3;
+    m_RowsRead = 0;
+    m_Maxval = maxval;
+    for (int value = 0; value < 256; value++)
+        m_Scale[value] = value >= maxval ? 255 : (unsigned char)((value * 255 + maxval / 2) / maxval);
+    return true;
+}
+
+bool PnmReader::ReadRows(unsigned char* dst, int rows, int stride)
+{
+    if (rows < 0 || rows > GetRowsLeft())
+        return false;
+    const size_t row = (size_t)m_Width * m_Channels;
+    if (stride == 0 || (size_t)stride == row)
+    {
+        m_File.read((char*)dst, (std::streamsize)(row * rows));
+        if (m_File)
+            ScaleRow(dst, row * rows);
+    }
+    else
+    {
+        for (int y = 0; y < rows && m_File; y++)
+        {
+            unsigned char* out = dst + (size_t)y * stride;
+            if (m_File.read((char*)out, (std::streamsize)row))
+                ScaleRow(out, row);
+        }
+    }
+    m_RowsRead += rows;
+    return (bool)m_File;
+}
+
+void PnmReader::ScaleRow(unsigned char* row, size_t count) const
+{
+    if (m_Maxval == 255)
+        return;
+    for (size_t i = 0; i < count; i++)
+        row[i] = m_Scale[row[i]];
+}
+
+PnmWriter::PnmWriter()
+    : m_Width(0), m_Height(0), m_Channels(0), m_RowsWritten(0)
+{
+}
+
+bool PnmWriter::Open(const std::string& filepath, int width, int height, int channels)
+{
+    if (width <= 0 || height <= 0 || (channels != 1 && channels != 3))
+        return false;
+    m_File.open(filepath, std::ios::binary);
+    if (!m_File)
+        return false;
+
+    m_Width = width;
+    m_Height = height;
+    m_Channels = channels;
+    m_RowsWritten = 0;
+    m_File << (channels == 1 ? "P5" : "P6") << "\n" << width << " " << height << "\n255\n";
+    return (bool)m_File;
+}
+
+bool PnmWriter::WriteRows(const unsigned char* src, int rows, int stride)
+{
+    if (rows < 0 || rows > GetRowsLeft())
+        return false;
+    const size_t row = (size_t)m_Width * m_Channels;
+    if (stride == 0 || (size_t)stride == row)
+    {
+        m_File.write((const char*)src, (std::streamsize)(row * rows));
+    }
+    else
+    {
+        for (int y = 0; y < rows && m_File; y++)
+            m_File.write((const char*)src + (size_t)y * stride, (std::streamsize)row);
+    }
+    m_RowsWritten += rows;
+    return (bool)m_File;
+}
+
+bool PnmWriter::Close()
+{
+    if (!m_File.is_open())
+        return false;
+    m_File.close();
+    return !m_File.fail() && m_RowsWritten == m_Height;
+}
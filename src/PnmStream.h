@@ -0,0 +1,59 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+
+// Binary PGM (P5, 1 channel) and PPM (P6, 3 channels) read and written a few rows at a
+// time. stb_image only decodes whole files and stb_image_write only encodes whole
+// images, so these are the formats the strip streamer uses for frames that don't fit
+// in memory. Only 8 bit samples (maxval 255 or less on input) are handled, and inputs
+// with a smaller maxval are scaled to 0..255 as they are read.
+class PnmReader
+{
+    private:
+        std::ifstream m_File;
+        int m_Width, m_Height, m_Channels;
+        int m_RowsRead;
+        int m_Maxval;
+        // Sample to 0..255 for a maxval below 255, values past maxval saturate
+        unsigned char m_Scale[256];
+    public:
+        PnmReader();
+
+        // Opens the file and parses the header, false if it isn't a P5 / P6 with 8 bit samples
+        bool Open(const std::string& filepath);
+
+        // Reads the next 'rows' rows into 'dst' ('stride' bytes apart, 0 means tightly
+        // packed), scaled to 0..255. False on a short file or when asked for more rows
+        // than are left.
+        bool ReadRows(unsigned char* dst, int rows, int stride = 0);
+
+        inline int GetWidth() const { return m_Width; }
+        inline int GetHeight() const { return m_Height; }
+        inline int GetChannels() const { return m_Channels; }
+        // The file's maxval, the rows come back scaled to 255 either way
+        inline int GetMaxval() const { return m_Maxval; }
+        inline int GetRowsLeft() const { return m_Height - m_RowsRead; }
+    private:
+        void ScaleRow(unsigned char* row, size_t count) const;
+};
+
+class PnmWriter
+{
+    private:
+        std::ofstream m_File;
+        int m_Width, m_Height, m_Channels;
+        int m_RowsWritten;
+    public:
+        PnmWriter();
+
+        // Writes the header: P5 for 1 channel, P6 for 3
+        bool Open(const std::string& filepath, int width, int height, int channels);
+
+        bool WriteRows(const unsigned char* src, int rows, int stride = 0);
+
+        // True once every row went out without an error
+        bool Close();
+
+        inline int GetRowsLeft() const { return m_Height - m_RowsWritten; }
+};
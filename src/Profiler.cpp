@@ -0,0 +1,139 @@
+#include <Profiler.h>
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    struct ProfileEvent
+    {
+        const char* name;
+        long long start, end;
+    };
+
+    // Ring of one thread's events. Only the owner writes; 'count' is published after
+    // the slot so a reader never sees an index ahead of its event.
+    struct ThreadEvents
+    {
+        int id;
+        std::atomic<const char*> name;
+        std::unique_ptr<ProfileEvent[]> events;
+        std::atomic<unsigned long long> count;
+    };
+
+    // Buffers outlive their threads so pools and batch stages that already exited still show up
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadEvents>> threads;
+    };
+
+    Registry& registry()
+    {
+        static Registry instance;
+        return instance;
+    }
+
+    thread_local ThreadEvents* t_Events = nullptr;
+    thread_local const char* t_Name = nullptr;
+
+    ThreadEvents& threadEvents()
+    {
+        if (!t_Events)
+        {
+            std::unique_ptr<ThreadEvents> events(new ThreadEvents());
+            events->name.store(t_Name);
+            events->events.reset(new ProfileEvent[Profiler::kEventsPerThread]);
+            events->count.store(0);
+
+            Registry& shared = registry();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            events->id = (int)shared.threads.size() + 1;
+            t_Events = events.get();
+            shared.threads.push_back(std::move(events));
+        }
+        return *t_Events;
+    }
+
+    void writeString(std::ostream& out, const char* text)
+    {
+        out << '"';
+        for (; *text; text++)
+        {
+            if (*text == '"' || *text == '\\')
+                out << '\\';
+            out << *text;
+        }
+        out << '"';
+    }
+}
+
+std::atomic<bool> Profiler::s_Enabled{false};
+
+void Profiler::Enable(bool enabled)
+{
+    s_Enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Profiler::SetThreadName(const char* name)
+{
+    t_Name = name;
+    if (t_Events)
+        t_Events->name.store(name);
+}
+
+long long Profiler::Now()
+{
+    static const Clock::time_point epoch = Clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - epoch).count();
+}
+
+void Profiler::Record(const char* name, long long start, long long end)
+{
+    ThreadEvents& thread = threadEvents();
+    const unsigned long long count = thread.count.load(std::memory_order_relaxed);
+    thread.events[count % kEventsPerThread] = ProfileEvent{name, start, end};
+    thread.count.store(count + 1, std::memory_order_release);
+}
+
+bool Profiler::WriteChromeTrace(const std::string& filepath)
+{
+    std::ofstream out(filepath);
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    out << "  {\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"graphics\"}}";
+
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    for (const std::unique_ptr<ThreadEvents>& thread : shared.threads)
+    {
+        const char* name = thread->name.load();
+        if (name)
+        {
+            out << ",\n  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << thread->id
+                << ", \"args\": {\"name\": ";
+            writeString(out, name);
+            out << "}}";
+        }
+
+        // Complete events ("X"), timestamps in microseconds
+        const unsigned long long count = thread->count.load(std::memory_order_acquire);
+        const unsigned long long first = count > kEventsPerThread ? count - kEventsPerThread : 0;
+        for (unsigned long long i = first; i < count; i++)
+        {
+            const ProfileEvent& event = thread->events[i % kEventsPerThread];
+            out << ",\n  {\"name\": ";
+            writeString(out, event.name);
+            out << ", \"ph\": \"X\", \"pid\": 1, \"tid\": " << thread->id << ", \"ts\": " << event.start / 1e3
+                << ", \"dur\": " << (event.end - event.start) / 1e3 << "}";
+        }
+    }
+    out << "\n]}\n";
+    return (bool)out;
+}
@@ -0,0 +1,235 @@
+#include <RecursiveGaussian.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    struct Coefficients
+    {
+        float b, a0, a1, a2;
+    };
+
+    // out[i] = b * x[i] + a0 * h1[i] + a1 * h2[i] + a2 * h3[i] for i in [from, count), 'out' may be 'x'.
+    // Every level adds in this order, with separate multiplies, so they all round alike.
+    void recurseScalar(const float* x, const float* h1, const float* h2, const float* h3, float* out,
+                       int from, int count, const Coefficients& c)
+    {
+        for (int i = from; i < count; i++)
+            out[i] = c.b * x[i] + c.a0 * h1[i] + c.a1 * h2[i] + c.a2 * h3[i];
+    }
+
+#if defined(GRAPHICS_SSE2)
+    int recurseSSE2(const float* x, const float* h1, const float* h2, const float* h3, float* out,
+                    int count, const Coefficients& c)
+    {
+        const __m128 b = _mm_set1_ps(c.b), a0 = _mm_set1_ps(c.a0), a1 = _mm_set1_ps(c.a1), a2 = _mm_set1_ps(c.a2);
+        int i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 sum = _mm_add_ps(_mm_mul_ps(b, _mm_loadu_ps(x + i)), _mm_mul_ps(a0, _mm_loadu_ps(h1 + i)));
+            sum = _mm_add_ps(sum, _mm_mul_ps(a1, _mm_loadu_ps(h2 + i)));
+            sum = _mm_add_ps(sum, _mm_mul_ps(a2, _mm_loadu_ps(h3 + i)));
+            _mm_storeu_ps(out + i, sum);
+        }
+        return i;
+    }
+#endif
+
+#if defined(GRAPHICS_AVX2)
+    GRAPHICS_TARGET_AVX2
+    int recurseAVX2(const float* x, const float* h1, const float* h2, const float* h3, float* out,
+                    int count, const Coefficients& c)
+    {
+        const __m256 b = _mm256_set1_ps(c.b), a0 = _mm256_set1_ps(c.a0);
+        const __m256 a1 = _mm256_set1_ps(c.a1), a2 = _mm256_set1_ps(c.a2);
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 sum = _mm256_add_ps(_mm256_mul_ps(b, _mm256_loadu_ps(x + i)), _mm256_mul_ps(a0, _mm256_loadu_ps(h1 + i)));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(a1, _mm256_loadu_ps(h2 + i)));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(a2, _mm256_loadu_ps(h3 + i)));
+            _mm256_storeu_ps(out + i, sum);
+        }
+        return i;
+    }
+#endif
+
+    // One step of the recursion for a row segment of 'count' columns
+    void recurseRow(const float* x, const float* h1, const float* h2, const float* h3, float* out,
+                    int count, const Coefficients& c, SimdLevel level)
+    {
+        int i = 0;
+        switch (level)
+        {
+#if defined(GRAPHICS_AVX2)
+            case SimdLevel::AVX2:
+                i = recurseAVX2(x, h1, h2, h3, out, count, c);
+                break;
+#endif
+#if defined(GRAPHICS_SSE2)
+            case SimdLevel::SSE2:
+                i = recurseSSE2(x, h1, h2, h3, out, count, c);
+                break;
+#endif
+            default:
+                break;
+        }
+        recurseScalar(x, h1, h2, h3, out, i, count, c);
+    }
+
+    inline unsigned char toByte(float value)
+    {
+        return value <= 0.0f ? 0 : value >= 255.0f ? 255 : (unsigned char)(value + 0.5f);
+    }
+}
+
+RecursiveGaussian::RecursiveGaussian(float sigma)
+    : m_Sigma(sigma), m_B(1.0f), m_A{0.0f, 0.0f, 0.0f}, m_Tail{}
+{
+    if (sigma < 0.5f)
+        return;
+
+    // Young and van Vliet (1995), eq. 11b / 11a for q and 8c for the coefficients
+    const double q = sigma >= 2.5 ? 0.98711 * sigma - 0.96330 : 3.97156 - 4.14554 * std::sqrt(1.0 - 0.26891 * sigma);
+    const double q2 = q * q, q3 = q2 * q;
+    const double b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+    const double a[3] = {(2.44413 * q + 2.85619 * q2 + 1.26661 * q3) / b0, -(1.4281 * q2 + 1.26661 * q3) / b0,
+                         0.422205 * q3 / b0};
+    const double b = 1.0 - (a[0] + a[1] + a[2]);
+    m_B = (float)b;
+    for (int k = 0; k < 3; k++)
+        m_A[k] = (float)a[k];
+
+    // Past the end the input stays at the last sample, so only the causal output's
+    // deviation from it is left to decay. Each unit deviation is run forward and back
+    // over an extension long enough for it to die out, which gives the matrix of
+    // Triggs and Sdika (2006) without its closed form.
+    const int length = 64 + (int)(32.0f * sigma);
+    std::vector<double> w(length + 3), y(length + 6);
+    for (int k = 0; k < 3; k++)
+    {
+        // w[0], w[1], w[2] stand for w[N - 3], w[N - 2], w[N - 1]
+        std::fill(w.begin(), w.end(), 0.0);
+        std::fill(y.begin(), y.end(), 0.0);
+        w[2 - k] = 1.0;
+        for (int n = 3; n < length + 3; n++)
+            w[n] = a[0] * w[n - 1] + a[1] * w[n - 2] + a[2] * w[n - 3];
+        for (int n = length + 2; n >= 3; n--)
+            y[n] = b * w[n] + a[0] * y[n + 1] + a[1] * y[n + 2] + a[2] * y[n + 3];
+        for (int i = 0; i < 3; i++)
+            m_Tail[i][k] = (float)y[3 + i];
+    }
+}
+
+void RecursiveGaussian::Apply(ConstImageView src, ImageView dst, ThreadPool& pool) const
+{
+    Apply(src, dst, pool, detectSimdLevel());
+}
+
+void RecursiveGaussian::Apply(ConstImageView src, ImageView dst, ThreadPool& pool, SimdLevel level) const
+{
+    const int width = src.GetWidth(), height = src.GetHeight();
+    if (src.IsEmpty())
+        return;
+    if (m_Sigma < 0.5f)
+    {
+        if (src.GetData() != dst.GetData())
+            copyPixels(src, dst);
+        return;
+    }
+    level = supportedSimdLevel(level);
+
+    std::vector<float> plane((size_t)width * height);
+    pool.ParallelRanges(height, 16, [&](int first, int last)
+    {
+        for (int y = first; y < last; y++)
+        {
+            const unsigned char* row = src.GetRow(y);
+            float* out = &plane[(size_t)y * width];
+            for (int x = 0; x < width; x++)
+                out[x] = row[x];
+        }
+    });
+
+    // Vertical: bands of whole kGroup column groups, so the vector loops run on full segments
+    const int kGroup = 16;
+    pool.ParallelRanges((width + kGroup - 1) / kGroup, 4, [&](int first, int last)
+    {
+        FilterColumns(plane.data(), height, width, first * kGroup, std::min(last * kGroup, width), level);
+    });
+
+    // Horizontal: a strip of kGroup rows is transposed into a width x kGroup buffer, which
+    // runs the same column recursion along the rows, and comes back as bytes
+    pool.ParallelRanges((height + kGroup - 1) / kGroup, 1, [&](int first, int last)
+    {
+        std::vector<float> strip((size_t)width * kGroup);
+        for (int s = first; s < last; s++)
+        {
+            const int top = s * kGroup, rows = std::min(kGroup, height - top);
+            for (int r = 0; r < rows; r++)
+            {
+                const float* row = &plane[(size_t)(top + r) * width];
+                for (int x = 0; x < width; x++)
+                    strip[(size_t)x * kGroup + r] = row[x];
+            }
+            FilterColumns(strip.data(), width, kGroup, 0, rows, level);
+            for (int r = 0; r < rows; r++)
+            {
+                unsigned char* out = dst.GetRow(top + r);
+                for (int x = 0; x < width; x++)
+                    out[x] = toByte(strip[(size_t)x * kGroup + r]);
+            }
+        }
+    });
+}
+
+void RecursiveGaussian::FilterColumns(float* plane, int rows, int columns, int first, int last, SimdLevel level) const
+{
+    const int count = last - first;
+    const Coefficients c = {m_B, m_A[0], m_A[1], m_A[2]};
+    auto row = [&](int n) { return plane + (size_t)n * columns + first; };
+
+    // The input rows at both ends (before they are overwritten) and the 3 anti-causal rows past the end
+    std::vector<float> edges(5 * (size_t)count);
+    float* head = edges.data();
+    float* end = head + count;
+    float* tail = end + count;
+    std::memcpy(head, row(0), count * sizeof(float));
+    std::memcpy(end, row(rows - 1), count * sizeof(float));
+
+    // Causal, in place. Rows before the first repeat it, which is its own steady state.
+    for (int n = 0; n < rows; n++)
+    {
+        float* out = row(n);
+        recurseRow(out, n >= 1 ? row(n - 1) : head, n >= 2 ? row(n - 2) : head, n >= 3 ? row(n - 3) : head, out,
+                   count, c, level);
+    }
+
+    for (int j = 0; j < count; j++)
+    {
+        float deviation[3];
+        for (int k = 0; k < 3; k++)
+            deviation[k] = (rows - 1 - k >= 0 ? row(rows - 1 - k)[j] : head[j]) - end[j];
+        for (int i = 0; i < 3; i++)
+        {
+            tail[(size_t)i * count + j] =
+                end[j] + m_Tail[i][0] * deviation[0] + m_Tail[i][1] * deviation[1] + m_Tail[i][2] * deviation[2];
+        }
+    }
+
+    // Anti-causal, in place over the causal output
+    auto after = [&](int n) { return n < rows ? row(n) : tail + (size_t)(n - rows) * count; };
+    for (int n = rows - 1; n >= 0; n--)
+    {
+        float* out = row(n);
+        recurseRow(out, after(n + 1), after(n + 2), after(n + 3), out, count, c, level);
+    }
+}
+
+void recursiveGaussian(ConstImageView src, ImageView dst, float sigma, ThreadPool& pool)
+{
+    RecursiveGaussian(sigma).Apply(src, dst, pool);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <ImageView.h>
+#include <Simd.h>
+#include <ThreadPool.h>
+
+// Gaussian blur of any sigma as the recursive (IIR) filter of Young and van Vliet: per
+// axis a causal and an anti-causal third order recursion, so the cost per pixel is the
+// same for sigma 2 and sigma 10. Borders repeat the edge pixels: the causal pass starts
+// in the steady state of the first sample and the anti-causal one from the exact state
+// past the last (Triggs and Sdika), so there is no ringing or darkening at the frame edge.
+// Each pass runs down the columns of a float plane with SIMD across the row and column
+// bands split across the pool. The horizontal pass does the same on a transposed copy.
+// The output is the same for every SimdLevel.
+class RecursiveGaussian
+{
+    private:
+        float m_Sigma;
+        // w[n] = m_B * x[n] + m_A[0] * w[n - 1] + m_A[1] * w[n - 2] + m_A[2] * w[n - 3],
+        // then the same from the end. The gain is 1, a constant comes out unchanged.
+        float m_B;
+        float m_A[3];
+        // Anti-causal state past the last sample (y[N], y[N + 1], y[N + 2]) from how far
+        // w[N - 1], w[N - 2] and w[N - 3] are off the last input sample
+        float m_Tail[3][3];
+    public:
+        // The approximation holds for sigma >= 0.5, below that the image is copied
+        explicit RecursiveGaussian(float sigma);
+
+        // One channel, same size, 'dst' may alias 'src'
+        void Apply(ConstImageView src, ImageView dst, ThreadPool& pool = ThreadPool::Global()) const;
+
+        // Same, forcing a specific implementation (falls back to the best supported one)
+        void Apply(ConstImageView src, ImageView dst, ThreadPool& pool, SimdLevel level) const;
+
+        inline float GetSigma() const { return m_Sigma; }
+    private:
+        // Both passes down columns [first, last) of a rows x columns float plane, in place
+        void FilterColumns(float* plane, int rows, int columns, int first, int last, SimdLevel level) const;
+};
+
+// RecursiveGaussian(sigma).Apply(src, dst, pool)
+void recursiveGaussian(ConstImageView src, ImageView dst, float sigma, ThreadPool& pool = ThreadPool::Global());
@@ -0,0 +1,208 @@
+#include <Resample.h>
+#include <Simd.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // floor(sum / n) as a multiply: exact for sum <= 255 * n and n < 2^20
+    struct Divider
+    {
+        unsigned long long multiplier;
+        Divider(unsigned int n) : multiplier(((1ull << 48) + n - 1) / n) {}
+        inline unsigned char operator()(unsigned int sum) const { return (unsigned char)((sum * multiplier) >> 48); }
+    };
+
+    // 2x2 block means of one channel, returns the first output column left to the scalar loop
+    int box2x2Row(const unsigned char* a, const unsigned char* b, unsigned char* out, int outWidth)
+    {
+        int x = 0;
+#if defined(GRAPHICS_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i ones = _mm_set1_epi16(1);
+        for (; x + 16 <= outWidth; x += 16)
+        {
+            __m128i a0 = _mm_loadu_si128((const __m128i*)(a + 2 * x));
+            __m128i a1 = _mm_loadu_si128((const __m128i*)(a + 2 * x + 16));
+            __m128i b0 = _mm_loadu_si128((const __m128i*)(b + 2 * x));
+            __m128i b1 = _mm_loadu_si128((const __m128i*)(b + 2 * x + 16));
+
+            // Vertical pairs in 16 bit, horizontal pairs with a multiply-add by 1
+            __m128i s0 = _mm_madd_epi16(_mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero)), ones);
+            __m128i s1 = _mm_madd_epi16(_mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero)), ones);
+            __m128i s2 = _mm_madd_epi16(_mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero)), ones);
+            __m128i s3 = _mm_madd_epi16(_mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero)), ones);
+
+            __m128i lo = _mm_packs_epi32(_mm_srli_epi32(s0, 2), _mm_srli_epi32(s1, 2));
+            __m128i hi = _mm_packs_epi32(_mm_srli_epi32(s2, 2), _mm_srli_epi32(s3, 2));
+            _mm_storeu_si128((__m128i*)(out + x), _mm_packus_epi16(lo, hi));
+        }
+#endif
+        for (; x < outWidth; x++)
+            out[x] = (unsigned char)((a[2 * x] + a[2 * x + 1] + b[2 * x] + b[2 * x + 1]) >> 2);
+        return x;
+    }
+
+    void integerRows(const unsigned char* src, int srcStride, unsigned char* dst, int dstStride,
+                     int outWidth, int channels, int fx, int fy, int first, int last)
+    {
+        if (fx == 2 && fy == 2 && channels == 1)
+        {
+            for (int y = first; y < last; y++)
+            {
+                box2x2Row(src + (size_t)(2 * y) * srcStride, src + (size_t)(2 * y + 1) * srcStride,
+                          dst + (size_t)y * dstStride, outWidth);
+            }
+            return;
+        }
+
+        const Divider divide(fx * fy);
+        const int samples = outWidth * fx * channels;
+        std::vector<unsigned int> column_sums(samples);
+        for (int y = first; y < last; y++)
+        {
+            // Vertical sums of the fy source rows (vectorizes), then fx-wide horizontal sums
+            const unsigned char* s = src + (size_t)y * fy * srcStride;
+            for (int i = 0; i < samples; i++)
+                column_sums[i] = s[i];
+            for (int r = 1; r < fy; r++)
+            {
+                s += srcStride;
+                for (int i = 0; i < samples; i++)
+                    column_sums[i] += s[i];
+            }
+
+            unsigned char* d = dst + (size_t)y * dstStride;
+            for (int x = 0; x < outWidth; x++)
+            {
+                for (int c = 0; c < channels; c++)
+                {
+                    unsigned int sum = 0;
+                    const unsigned int* block = &column_sums[(size_t)x * fx * channels + c];
+                    for (int k = 0; k < fx; k++)
+                        sum += block[k * channels];
+                    d[x * channels + c] = divide(sum);
+                }
+            }
+        }
+    }
+
+    // Source pixels covering each output pixel along one axis, with overlap weights summing to 1
+    struct AreaAxis
+    {
+        std::vector<int> first, count, offset;
+        std::vector<float> weights;
+
+        AreaAxis(int in, int out)
+            : first(out), count(out), offset(out)
+        {
+            const double scale = (double)in / out;
+            for (int o = 0; o < out; o++)
+            {
+                const double start = o * scale, end = (o + 1) * scale;
+                const int i0 = (int)std::floor(start);
+                const int i1 = std::min(in, (int)std::ceil(end));
+                first[o] = i0;
+                count[o] = i1 - i0;
+                offset[o] = (int)weights.size();
+                for (int i = i0; i < i1; i++)
+                {
+                    const double overlap = std::min(end, (double)(i + 1)) - std::max(start, (double)i);
+                    weights.push_back((float)(overlap / scale));
+                }
+            }
+        }
+    };
+
+    void fractionalRows(const unsigned char* src, int srcStride, unsigned char* dst, int dstStride,
+                        int outWidth, int channels, const AreaAxis& columns, const AreaAxis& rows,
+                        int first, int last)
+    {
+        std::vector<float> horizontal((size_t)outWidth * channels), accumulator((size_t)outWidth * channels);
+        for (int y = first; y < last; y++)
+        {
+            std::fill(accumulator.begin(), accumulator.end(), 0.0f);
+            for (int k = 0; k < rows.count[y]; k++)
+            {
+                const unsigned char* s = src + (size_t)(rows.first[y] + k) * srcStride;
+                const float wy = rows.weights[rows.offset[y] + k];
+                for (int x = 0; x < outWidth; x++)
+                {
+                    for (int c = 0; c < channels; c++)
+                    {
+                        float sum = 0.0f;
+                        for (int j = 0; j < columns.count[x]; j++)
+                            sum += columns.weights[columns.offset[x] + j] * s[(columns.first[x] + j) * channels + c];
+                        horizontal[x * channels + c] = sum;
+                    }
+                }
+                for (size_t i = 0; i < accumulator.size(); i++)
+                    accumulator[i] += wy * horizontal[i];
+            }
+
+            unsigned char* d = dst + (size_t)y * dstStride;
+            for (size_t i = 0; i < accumulator.size(); i++)
+                d[i] = (unsigned char)std::min(255.0f, accumulator[i] + 0.5f);
+        }
+    }
+}
+
+void areaResample(const unsigned char* src, int width, int height, int srcStride,
+                  unsigned char* dst, int outWidth, int outHeight, int dstStride,
+                  int channels, ThreadPool& pool)
+{
+    if (width <= 0 || height <= 0 || outWidth <= 0 || outHeight <= 0)
+        return;
+    if (srcStride == 0)
+        srcStride = width * channels;
+    if (dstStride == 0)
+        dstStride = outWidth * channels;
+
+    // Rows are independent, keep bands big enough to be worth a hand-off
+    const int grain = std::max(1, (1 << 16) / (width * channels * std::max(1, height / outHeight)));
+
+    if (width % outWidth == 0 && height % outHeight == 0)
+    {
+        const int fx = width / outWidth, fy = height / outHeight;
+        pool.ParallelRanges(outHeight, grain, [&](int first, int last)
+        {
+            integerRows(src, srcStride, dst, dstStride, outWidth, channels, fx, fy, first, last);
+        });
+        return;
+    }
+
+    const AreaAxis columns(width, outWidth), rows(height, outHeight);
+    pool.ParallelRanges(outHeight, grain, [&](int first, int last)
+    {
+        fractionalRows(src, srcStride, dst, dstStride, outWidth, channels, columns, rows, first, last);
+    });
+}
+
+Image areaResample(const Image& src, int outWidth, int outHeight, ThreadPool& pool)
+{
+    Image out(outWidth, outHeight, src.GetChannels());
+    areaResample(src.GetData(), src.GetWidth(), src.GetHeight(), src.GetStride(),
+                 out.GetData(), outWidth, outHeight, out.GetStride(), src.GetChannels(), pool);
+    return out;
+}
+
+std::vector<Image> buildPyramid(const Image& base, int maxLevels, ThreadPool& pool)
+{
+    std::vector<Image> levels;
+    if (base.IsEmpty())
+        return levels;
+
+    levels.push_back(base.Clone());
+    while (maxLevels <= 0 || (int)levels.size() < maxLevels)
+    {
+        const Image& previous = levels.back();
+        if (previous.GetWidth() == 1 && previous.GetHeight() == 1)
+            break;
+        const int w = std::max(1, previous.GetWidth() / 2);
+        const int h = std::max(1, previous.GetHeight() / 2);
+        Image next = areaResample(previous, w, h, pool);
+        levels.push_back(std::move(next));
+    }
+    return levels;
+}
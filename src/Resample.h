@@ -0,0 +1,24 @@
+#pragma once
+
+#include <Image.h>
+#include <ThreadPool.h>
+
+#include <vector>
+
+// Area (box) resampling of 8 bit images with 1 to 4 interleaved channels.
+// Every output pixel is the mean of the source area it covers.
+//  - Integer factors (width % outWidth == 0 and height % outHeight == 0) sum whole
+//    blocks and round down, exactly like compressImage(). 2x2 on one channel uses SSE2.
+//  - Other sizes weight the partially covered edge pixels by their overlap and round
+//    to nearest. Growing an image this way gives a nearest/linear blend.
+// Output rows are split across the pool. Strides are in bytes, 0 means tightly packed.
+void areaResample(const unsigned char* src, int width, int height, int srcStride,
+                  unsigned char* dst, int outWidth, int outHeight, int dstStride,
+                  int channels = 1, ThreadPool& pool = ThreadPool::Global());
+
+Image areaResample(const Image& src, int outWidth, int outHeight, ThreadPool& pool = ThreadPool::Global());
+
+// Mip chain: level 0 is a copy of 'base', each next level is max(1, size / 2) of the
+// previous one, computed from it rather than from the base. Stops at 1x1 or after
+// 'maxLevels' levels (0 means no limit).
+std::vector<Image> buildPyramid(const Image& base, int maxLevels = 0, ThreadPool& pool = ThreadPool::Global());
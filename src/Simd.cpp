@@ -0,0 +1,25 @@
+#include <Simd.h>
+
+SimdLevel detectSimdLevel()
+{
+    static const SimdLevel level = []()
+    {
+#if defined(GRAPHICS_AVX2)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return SimdLevel::AVX2;
+#endif
+#if defined(GRAPHICS_SSE2)
+        return SimdLevel::SSE2;
+#else
+        return SimdLevel::Scalar;
+#endif
+    }();
+    return level;
+}
+
+SimdLevel supportedSimdLevel(SimdLevel requested)
+{
+    SimdLevel best = detectSimdLevel();
+    return (int)requested < (int)best ? requested : best;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+// x86 SIMD kernels are compiled when the target has SSE2 (always true on x86-64).
+// AVX2 variants are compiled with a target attribute and picked at runtime.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GRAPHICS_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define GRAPHICS_AVX2 1
+#define GRAPHICS_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+#endif
+
+enum class SimdLevel
+{
+    Scalar, SSE2, AVX2
+};
+
+// Best instruction set available on this CPU (checked once)
+SimdLevel detectSimdLevel();
+
+// Clamps a requested level to what this build and CPU support
+SimdLevel supportedSimdLevel(SimdLevel requested);
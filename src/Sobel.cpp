@@ -0,0 +1,112 @@
+#include <Sobel.h>
+
+#include <cmath>
+
+static void sobelRowScalar(const unsigned char* up, const unsigned char* row, const unsigned char* down,
+                           unsigned char* magnitude, unsigned char* direction, int from, int width,
+                           GradientNorm norm)
+{
+    for (int j = from; j < width - 1; j++)
+    {
+        int gx = (up[j + 1] - up[j - 1]) + 2 * (row[j + 1] - row[j - 1]) + (down[j + 1] - down[j - 1]);
+        int gy = (down[j - 1] + 2 * down[j] + down[j + 1]) - (up[j - 1] + 2 * up[j] + up[j + 1]);
+
+        int gradient;
+        if (norm == GradientNorm::L1)
+            gradient = (gx < 0 ? -gx : gx) + (gy < 0 ? -gy : gy);
+        else
+            gradient = (int)std::sqrt((float)(gx * gx + gy * gy));
+
+        magnitude[j] = (unsigned char)(gradient < 255 ? gradient : 255);
+        direction[j] = sobelDirection(gx, gy);
+    }
+}
+
+#if defined(GRAPHICS_SSE2)
+static inline __m128i load8(const unsigned char* p, __m128i zero)
+{
+    return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)p), zero);
+}
+
+static inline __m128i abs16(__m128i x)
+{
+    return _mm_max_epi16(x, _mm_sub_epi16(_mm_setzero_si128(), x));
+}
+
+// a.x * b.x + a.y * b.y for the 4 low / high interleaved pairs
+static inline __m128i dotLo(__m128i x, __m128i y) { __m128i v = _mm_unpacklo_epi16(x, y); return _mm_madd_epi16(v, v); }
+static inline __m128i dotHi(__m128i x, __m128i y) { __m128i v = _mm_unpackhi_epi16(x, y); return _mm_madd_epi16(v, v); }
+
+static inline __m128i sqrtTrunc(__m128i n)
+{
+    // n < 2^24 is exact in float and the clamp to 255 hides any rounding above that
+    return _mm_cvttps_epi32(_mm_sqrt_ps(_mm_cvtepi32_ps(n)));
+}
+
+static int sobelRowSSE2(const unsigned char* up, const unsigned char* row, const unsigned char* down,
+                        unsigned char* magnitude, unsigned char* direction, int width,
+                        GradientNorm norm)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i two = _mm_set1_epi16(2);
+    const __m128i one = _mm_set1_epi16(1);
+    int j = 1;
+    // 8 outputs per step, reading [j - 1, j + 8]
+    for (; j + 8 < width; j += 8)
+    {
+        __m128i ul = load8(up + j - 1, zero), uc = load8(up + j, zero), ur = load8(up + j + 1, zero);
+        __m128i rl = load8(row + j - 1, zero), rr = load8(row + j + 1, zero);
+        __m128i dl = load8(down + j - 1, zero), dc = load8(down + j, zero), dr = load8(down + j + 1, zero);
+
+        __m128i gx = _mm_add_epi16(_mm_add_epi16(_mm_sub_epi16(ur, ul), _mm_sub_epi16(dr, dl)),
+                                   _mm_slli_epi16(_mm_sub_epi16(rr, rl), 1));
+        __m128i gy = _mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(dl, dr), _mm_slli_epi16(dc, 1)),
+                                   _mm_add_epi16(_mm_add_epi16(ul, ur), _mm_slli_epi16(uc, 1)));
+
+        __m128i ax = abs16(gx), ay = abs16(gy);
+        __m128i s = _mm_add_epi16(ax, ay);
+
+        __m128i mag;
+        if (norm == GradientNorm::L1)
+        {
+            mag = s;
+        }
+        else
+        {
+            mag = _mm_packs_epi32(sqrtTrunc(dotLo(gx, gy)), sqrtTrunc(dotHi(gx, gy)));
+        }
+        _mm_storel_epi64((__m128i*)(magnitude + j), _mm_packus_epi16(mag, mag));
+
+        // s^2 > 2 ax^2 -> not horizontal, 2 ay^2 > s^2 -> vertical
+        __m128i s2Lo = dotLo(s, zero), s2Hi = dotHi(s, zero);
+        __m128i notHorizontal = _mm_packs_epi32(_mm_cmpgt_epi32(s2Lo, dotLo(ax, ax)), _mm_cmpgt_epi32(s2Hi, dotHi(ax, ax)));
+        __m128i vertical = _mm_packs_epi32(_mm_cmpgt_epi32(dotLo(ay, ay), s2Lo), _mm_cmpgt_epi32(dotHi(ay, ay), s2Hi));
+        __m128i opposite = _mm_srai_epi16(_mm_xor_si128(gx, gy), 15);
+
+        __m128i diagonal = _mm_or_si128(one, _mm_and_si128(opposite, two));
+        __m128i code = _mm_or_si128(_mm_and_si128(vertical, two), _mm_andnot_si128(vertical, diagonal));
+        code = _mm_and_si128(notHorizontal, code);
+        _mm_storel_epi64((__m128i*)(direction + j), _mm_packus_epi16(code, code));
+    }
+    return j;
+}
+#endif
+
+void sobelRow(const unsigned char* up, const unsigned char* row, const unsigned char* down,
+              unsigned char* magnitude, unsigned char* direction, int width,
+              GradientNorm norm, SimdLevel level)
+{
+    int j = 1;
+#if defined(GRAPHICS_SSE2)
+    if (supportedSimdLevel(level) != SimdLevel::Scalar)
+        j = sobelRowSSE2(up, row, down, magnitude, direction, width, norm);
+#endif
+    sobelRowScalar(up, row, down, magnitude, direction, j, width, norm);
+}
+
+void sobelRow(const unsigned char* up, const unsigned char* row, const unsigned char* down,
+              unsigned char* magnitude, unsigned char* direction, int width,
+              GradientNorm norm)
+{
+    sobelRow(up, row, down, magnitude, direction, width, norm, detectSimdLevel());
+}
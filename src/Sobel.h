@@ -0,0 +1,45 @@
+#pragma once
+
+#include <Simd.h>
+
+/* Non-maximum suppression directions (which pair of neighbours is compared) */
+enum EdgeDirection : unsigned char
+{
+    EDGE_DIR_0   = 0,   // (i,j+1),(i,j-1)
+    EDGE_DIR_45  = 1,   // (i+1,j+1),(i-1,j-1)
+    EDGE_DIR_90  = 2,   // (i+1,j),(i-1,j)
+    EDGE_DIR_135 = 3    // (i+1,j-1),(i-1,j+1)
+};
+
+enum class GradientNorm
+{
+    L2,     // min(255, floor(sqrt(gx^2 + gy^2)))
+    L1      // min(255, |gx| + |gy|), cheaper and slightly larger on diagonals
+};
+
+// Direction code of a Sobel gradient, the atan2() angle binned into 22.5 degree sectors.
+// tan(22.5) = sqrt(2) - 1, so |gy| <= tan(22.5) * |gx| is the exact integer test
+// (|gx| + |gy|)^2 <= 2 * gx^2 (and the same with gx and gy swapped for 67.5).
+inline unsigned char sobelDirection(int gx, int gy)
+{
+    int ax = gx < 0 ? -gx : gx;
+    int ay = gy < 0 ? -gy : gy;
+    int s = ax + ay;
+    if (s * s <= 2 * ax * ax)
+        return EDGE_DIR_0;
+    if (s * s < 2 * ay * ay)
+        return EDGE_DIR_90;
+    return ((gx ^ gy) < 0) ? EDGE_DIR_135 : EDGE_DIR_45;
+}
+
+// Sobel (GaussX / GaussY) over the interior pixels [1, width - 2] of one row.
+// Writes the clamped magnitude and the EdgeDirection code of every pixel;
+// magnitude[0], magnitude[width - 1] and the matching direction bytes are not written.
+void sobelRow(const unsigned char* up, const unsigned char* row, const unsigned char* down,
+              unsigned char* magnitude, unsigned char* direction, int width,
+              GradientNorm norm = GradientNorm::L2);
+
+// Same, forcing a specific implementation (falls back to the best supported one)
+void sobelRow(const unsigned char* up, const unsigned char* row, const unsigned char* down,
+              unsigned char* magnitude, unsigned char* direction, int width,
+              GradientNorm norm, SimdLevel level);
@@ -0,0 +1,117 @@
+#include <StreamPipeline.h>
+#include <ColorConvert.h>
+#include <Halftone.h>
+#include <Image.h>
+#include <PnmStream.h>
+#include <Profiler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <utility>
+
+StreamReport runStreaming(const std::string& input, ThreadPool& pool, const StreamOptions& options)
+{
+    StreamReport report;
+    const auto start = std::chrono::steady_clock::now();
+
+    PnmReader reader;
+    if (!reader.Open(input))
+        return report;
+    const int width = reader.GetWidth();
+    const int height = reader.GetHeight();
+    const int channels = reader.GetChannels();
+    const int strip_rows = std::max(1, std::min(options.stripRows, height));
+    report.width = width;
+    report.height = height;
+
+    std::error_code error;
+    std::filesystem::create_directories(options.outputDirectory, error);
+    std::string stem = options.outputDirectory;
+    if (!stem.empty() && stem.back() != '/')
+        stem += '/';
+    stem += std::filesystem::path(input).stem().string();
+
+    PnmWriter grayscale_out, canny_out, halftone_out, dither_out;
+    if (!grayscale_out.Open(stem + "_Grayscale.pgm", width, height, 1) ||
+        !canny_out.Open(stem + "_Canny.pgm", width, height, 1) ||
+        !halftone_out.Open(stem + "_Haftone.pgm", width, height, 1) ||
+        !dither_out.Open(stem + "_FloyedSteinberg.pgm", width, height, 1))
+        return report;
+
+    CannyParams canny_params = options.canny;
+    if (canny_params.hysteresis == HysteresisMode::Connected)
+        canny_params.hysteresis = HysteresisMode::Neighbours;
+    CannyEngine canny(width, canny_params);
+    canny.Begin(height);
+    std::unique_ptr<DitherStream> dither = createDitherStream(options.ditherKernel, width, options.serpentine);
+
+    // The strip being read and the strip being filtered swap every round
+    Image reading(width, strip_rows, channels);
+    Image current(width, strip_rows, channels);
+    Image gray(width, strip_rows, 1);
+    Image halftone(width, strip_rows, 1);
+    Image dithered(width, strip_rows, 1);
+    // 3 row rings of source, blur, magnitude, direction and edges plus one output row
+    // (CannyEngine), at most 3 error rows of ints (the dither)
+    report.workingBytes = reading.GetSize() + current.GetSize() + gray.GetSize() + halftone.GetSize() +
+                          dithered.GetSize() + (size_t)width * 16 + (size_t)(width + 4) * 3 * sizeof(int);
+
+    bool ok = true;
+    int rows = std::min(strip_rows, height);
+    ok = reader.ReadRows(current.GetData(), rows, current.GetStride());
+
+    for (int y = 0; ok && y < height; y += rows)
+    {
+        PROFILE_SCOPE("strip");
+        rows = std::min(strip_rows, height - y);
+        lumaImage(current.GetData(), current.GetStride(), channels == 1 ? PixelFormat::Gray : PixelFormat::RGB,
+                  gray.GetData(), gray.GetStride(), width, rows, pool);
+        fusedHalftone(gray.GetData(), width, rows, gray.GetStride(), halftone.GetData(), width, rows,
+                      halftone.GetStride(), pool);
+        ok = grayscale_out.WriteRows(gray.GetData(), rows, gray.GetStride()) &&
+             halftone_out.WriteRows(halftone.GetData(), rows, halftone.GetStride());
+
+        // Canny, the dither and reading the next strip only share the gray strip, read-only
+        const int next_rows = std::min(strip_rows, height - y - rows);
+        bool canny_ok = true, dither_ok = true, read_ok = true;
+        pool.ParallelFor(3, [&](int task)
+        {
+            if (task == 0)
+            {
+                PROFILE_SCOPE("strip Canny");
+                for (int i = 0; i < rows; i++)
+                {
+                    canny.PushRow(gray.GetRow(i), [&](const unsigned char* row, int)
+                    {
+                        canny_ok = canny_out.WriteRows(row, 1) && canny_ok;
+                    });
+                }
+            }
+            else if (task == 1)
+            {
+                PROFILE_SCOPE("strip dither");
+                dither->Process(gray.GetData(), rows, gray.GetStride(), dithered.GetData(), dithered.GetStride());
+                dither_ok = dither_out.WriteRows(dithered.GetData(), rows, dithered.GetStride());
+            }
+            else if (next_rows > 0)
+            {
+                PROFILE_SCOPE("strip read");
+                read_ok = reader.ReadRows(reading.GetData(), next_rows, reading.GetStride());
+            }
+        });
+        ok = ok && canny_ok && dither_ok && read_ok;
+        std::swap(reading, current);
+    }
+
+    canny.Finish([&](const unsigned char* row, int) { ok = canny_out.WriteRows(row, 1) && ok; });
+
+    ok = grayscale_out.Close() && ok;
+    ok = canny_out.Close() && ok;
+    ok = halftone_out.Close() && ok;
+    ok = dither_out.Close() && ok;
+    report.ok = ok;
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
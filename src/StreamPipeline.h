@@ -0,0 +1,42 @@
+#pragma once
+
+#include <CannyEngine.h>
+#include <Dither.h>
+#include <ThreadPool.h>
+
+#include <string>
+
+struct StreamOptions
+{
+    // Outputs land here as <input name>_<stage>.pgm
+    std::string outputDirectory = "out/";
+
+    // Rows read, converted and written at once
+    int stripRows = 64;
+
+    // Connected hysteresis needs the whole edge map, streaming runs Neighbours instead.
+    // The recursive blur needs whole columns and falls back to the 3x3 kernel.
+    CannyParams canny;
+
+    DiffusionKernel ditherKernel = DiffusionKernel::FloydSteinberg;
+    bool serpentine = false;
+};
+
+struct StreamReport
+{
+    bool ok = false;
+    int width = 0, height = 0;
+    // Everything the stages hold at once: strips, Canny row rings and dither error rows
+    size_t workingBytes = 0;
+    double seconds = 0;
+};
+
+// Grayscale -> Canny / Halftone / error diffusion over a binary PGM or PPM that is never
+// in memory as a whole. The input is read in strips of stripRows rows, each stage only
+// keeps the rows its neighbourhood needs (3 row rings for Canny, kRows error rows for the
+// dither), and every output is written band by band as a PGM. Memory grows with the
+// width and stripRows, not with the height. While one strip goes through Canny and the
+// dither, the next one is read. Halftone is written at the input size. Outputs match
+// ImagePipeline with Neighbours hysteresis.
+StreamReport runStreaming(const std::string& input, ThreadPool& pool = ThreadPool::Global(),
+                          const StreamOptions& options = StreamOptions());
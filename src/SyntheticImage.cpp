@@ -0,0 +1,144 @@
+#include <SyntheticImage.h>
+
+#include <algorithm>
+
+namespace
+{
+    // splitmix64 finalizer over the packed coordinates
+    inline unsigned long long hash(unsigned long long seed, unsigned long long a, unsigned long long b)
+    {
+        unsigned long long z = seed * 0x9E3779B97F4A7C15ull + (a << 32 | (b & 0xFFFFFFFFull));
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Lattice value in 16 bit fixed point
+    inline long long latticeValue(unsigned long long seed, int x, int y)
+    {
+        return (long long)(hash(seed, (unsigned int)x, (unsigned int)y) >> 48);
+    }
+
+    // 3t^2 - 2t^3 with t in 16 bit fixed point
+    inline long long smooth(long long t)
+    {
+        return (t * t >> 16) * (3 * 65536 - 2 * t) >> 16;
+    }
+
+    // Sum of 6 octaves of bilinear value noise, 0..255. Integer only, so the pixels
+    // don't depend on the compiler's floating point choices.
+    unsigned char fractalNoise(unsigned int seed, int x, int y, int period)
+    {
+        long long value = 0, total = 0;
+        for (int octave = 0, amplitude = 32; octave < 6; octave++, period = std::max(1, period / 2), amplitude /= 2)
+        {
+            const int cx = x / period, cy = y / period;
+            const long long fx = smooth(((long long)(x % period) << 16) / period);
+            const long long fy = smooth(((long long)(y % period) << 16) / period);
+            const unsigned long long s = (unsigned long long)seed * 8 + octave;
+            const long long v00 = latticeValue(s, cx, cy), v10 = latticeValue(s, cx + 1, cy);
+            const long long v01 = latticeValue(s, cx, cy + 1), v11 = latticeValue(s, cx + 1, cy + 1);
+            const long long top = v00 + ((v10 - v00) * fx >> 16);
+            const long long bottom = v01 + ((v11 - v01) * fx >> 16);
+            value += amplitude * (top + ((bottom - top) * fy >> 16));
+            total += amplitude;
+        }
+        return (unsigned char)(value / total >> 8);
+    }
+}
+
+const char* syntheticPatternName(SyntheticPattern pattern)
+{
+    switch (pattern)
+    {
+        case SyntheticPattern::Noise: return "noise";
+        case SyntheticPattern::Gradient: return "gradient";
+        case SyntheticPattern::Checkerboard: return "checkerboard";
+        default: return "fractal";
+    }
+}
+
+bool parseSyntheticPattern(const std::string& name, SyntheticPattern& pattern)
+{
+    const SyntheticPattern all[] = {SyntheticPattern::Noise, SyntheticPattern::Gradient,
+                                    SyntheticPattern::Checkerboard, SyntheticPattern::Fractal};
+    for (SyntheticPattern candidate : all)
+    {
+        if (name == syntheticPatternName(candidate))
+        {
+            pattern = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+Image makeSyntheticImage(SyntheticPattern pattern, int width, int height, int channels, unsigned int seed, ThreadPool& pool)
+{
+    Image image(width, height, channels);
+    if (image.IsEmpty())
+        return image;
+
+    // Squares and noise features scale with the image so every size looks alike
+    const int cell = std::max(8, std::min(width, height) / 16);
+    const int period = std::max(2, std::min(width, height) / 4);
+
+    pool.ParallelRanges(height, std::max(1, (1 << 16) / width), [&](int first, int last)
+    {
+        for (int y = first; y < last; y++)
+        {
+            unsigned char* row = image.GetRow(y);
+            for (int x = 0; x < width; x++)
+            {
+                unsigned char rgb[3];
+                switch (pattern)
+                {
+                    case SyntheticPattern::Noise:
+                    {
+                        const unsigned long long bits = hash(seed, (unsigned int)x, (unsigned int)y);
+                        rgb[0] = (unsigned char)bits;
+                        rgb[1] = (unsigned char)(bits >> 8);
+                        rgb[2] = (unsigned char)(bits >> 16);
+                        break;
+                    }
+                    case SyntheticPattern::Gradient:
+                        rgb[0] = (unsigned char)(width > 1 ? x * 255 / (width - 1) : 0);
+                        rgb[1] = (unsigned char)(height > 1 ? y * 255 / (height - 1) : 0);
+                        rgb[2] = (unsigned char)((long long)(x + y) * 255 / std::max(1, width + height - 2));
+                        break;
+                    case SyntheticPattern::Checkerboard:
+                    {
+                        const bool light = ((x / cell) + (y / cell)) % 2 == 0;
+                        rgb[0] = light ? 230 : 20;
+                        rgb[1] = light ? 220 : 30;
+                        rgb[2] = light ? 200 : 40;
+                        break;
+                    }
+                    default:
+                    {
+                        const int v = fractalNoise(seed, x, y, period);
+                        rgb[0] = (unsigned char)std::min(255, v * 6 / 5);
+                        rgb[1] = (unsigned char)v;
+                        rgb[2] = (unsigned char)(v * 4 / 5 + 20);
+                        break;
+                    }
+                }
+
+                unsigned char* pixel = row + (size_t)x * channels;
+                if (channels < 3)
+                {
+                    pixel[0] = (unsigned char)((rgb[0] + rgb[1] + rgb[2]) / 3);
+                }
+                else
+                {
+                    pixel[0] = rgb[0];
+                    pixel[1] = rgb[1];
+                    pixel[2] = rgb[2];
+                }
+                if (channels == 2 || channels == 4)
+                    pixel[channels - 1] = 255;
+            }
+        }
+    });
+    return image;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <Image.h>
+#include <ThreadPool.h>
+
+#include <string>
+
+enum class SyntheticPattern
+{
+    Noise,          // every channel uniform random, the worst case for compression and edges
+    Gradient,       // smooth ramps, red along x, green along y, blue along the diagonal
+    Checkerboard,   // hard edges every few pixels
+    Fractal         // 6 octave value noise, close to the statistics of a photo
+};
+
+// Same pattern, size and seed give the same pixels on every machine and thread count:
+// pixels come from a hash of (seed, x, y), not from a stateful generator.
+Image makeSyntheticImage(SyntheticPattern pattern, int width, int height, int channels = 4,
+                         unsigned int seed = 1, ThreadPool& pool = ThreadPool::Global());
+
+// "noise", "gradient", "checkerboard", "fractal"
+const char* syntheticPatternName(SyntheticPattern pattern);
+// False when 'name' isn't one of the above
+bool parseSyntheticPattern(const std::string& name, SyntheticPattern& pattern);
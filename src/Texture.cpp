@@ -3,8 +3,52 @@
 
 #include <Texture.h>
 
+static PixelFormat formatFromChannels(int channels)
+{
+    switch (channels)
+    {
+        case 1: return PixelFormat::Gray;
+        case 2: return PixelFormat::GrayAlpha;
+        case 3: return PixelFormat::RGB;
+        default: return PixelFormat::RGBA;
+    }
+}
+
+// Internal format, pixel format of the client data
+static void glFormats(PixelFormat format, GLenum& internalFormat, GLenum& dataFormat)
+{
+    switch (format)
+    {
+        case PixelFormat::Gray: internalFormat = GL_R8; dataFormat = GL_RED; break;
+        case PixelFormat::GrayAlpha: internalFormat = GL_RG8; dataFormat = GL_RG; break;
+        case PixelFormat::RGB: internalFormat = GL_RGB8; dataFormat = GL_RGB; break;
+        case PixelFormat::BGRA: internalFormat = GL_RGBA8; dataFormat = GL_BGRA; break;
+        default: internalFormat = GL_RGBA8; dataFormat = GL_RGBA; break;
+    }
+}
+
+// Sets the unpack state for rows of 'stride' bytes, returns false if GL can't express the stride
+static bool setUnpackRows(PixelFormat format, int width, int stride)
+{
+    const int bpp = bytesPerPixel(format);
+    if (stride == 0)
+        stride = width * bpp;
+    if (stride % bpp != 0)
+        return false;
+    GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+    GLCall(glPixelStorei(GL_UNPACK_ROW_LENGTH, stride / bpp));
+    return true;
+}
+
+static void resetUnpackRows()
+{
+    GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+    GLCall(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+}
+
 Texture::Texture(const std::string& filepath)
-    : m_RendererID(0), m_Filepath(filepath), m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_Components(0)
+    : m_RendererID(0), m_Filepath(filepath), m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_Components(0),
+      m_Format(PixelFormat::RGBA)
 {
     // Flips the image so it appears right side up
     stbi_set_flip_vertically_on_load(1);
@@ -12,6 +56,33 @@ Texture::Texture(const std::string& filepath)
     // Reads the image from a file and stores it in m_LocalBuffer
     m_LocalBuffer = stbi_load(filepath.c_str(), &m_Width, &m_Height, &m_Components, 4);
 
+    Create(m_LocalBuffer, 0);
+
+    if (m_LocalBuffer)
+    {
+        // Deletes the image data as it is already in the OpenGL Texture object
+        stbi_image_free(m_LocalBuffer);
+        m_LocalBuffer = nullptr;
+    }
+}
+
+Texture::Texture(const unsigned char* data, int width, int height, PixelFormat format, int stride)
+    : m_RendererID(0), m_LocalBuffer(nullptr), m_Width(width), m_Height(height), m_Components(bytesPerPixel(format)),
+      m_Format(format)
+{
+    Create(data, stride);
+}
+
+Texture::Texture(const Image& image)
+    : Texture(image.GetData(), image.GetWidth(), image.GetHeight(), formatFromChannels(image.GetChannels()), image.GetStride())
+{
+}
+
+void Texture::Create(const unsigned char* data, int stride)
+{
+    GLenum internalFormat, dataFormat;
+    glFormats(m_Format, internalFormat, dataFormat);
+
     // Generates an OpenGL texture object
     GLCall(glGenTextures(1, &m_RendererID));
 
@@ -26,20 +97,49 @@ Texture::Texture(const std::string& filepath)
     GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT));
 	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
 
+    // Single channel textures are sampled as grey with opaque alpha, grey + alpha ones
+    // keep their alpha in the green channel
+    if (m_Format == PixelFormat::Gray)
+    {
+        const GLint swizzle[4] = { GL_RED, GL_RED, GL_RED, GL_ONE };
+        GLCall(glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle));
+    }
+    else if (m_Format == PixelFormat::GrayAlpha)
+    {
+        const GLint swizzle[4] = { GL_RED, GL_RED, GL_RED, GL_GREEN };
+        GLCall(glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle));
+    }
+
     // Assigns the image to the OpenGL Texture object
-    GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_LocalBuffer));
+    if (!setUnpackRows(m_Format, m_Width, stride))
+    {
+        std::cout << "[Texture] stride " << stride << " is not a whole number of pixels" << std::endl;
+        data = nullptr;
+    }
+    GLCall(glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, m_Width, m_Height, 0, dataFormat, GL_UNSIGNED_BYTE, data));
+    resetUnpackRows();
 
     // Generates Mipmaps
 	GLCall(glGenerateMipmap(GL_TEXTURE_2D));
 
     // Unbinds the OpenGL Texture object so that it can't accidentally be modified
     GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+}
 
-    if (m_LocalBuffer)
+void Texture::Update(const unsigned char* data, int x, int y, int width, int height, int stride)
+{
+    GLenum internalFormat, dataFormat;
+    glFormats(m_Format, internalFormat, dataFormat);
+
+    GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+    if (setUnpackRows(m_Format, width, stride))
     {
-        // Deletes the image data as it is already in the OpenGL Texture object
-        stbi_image_free(m_LocalBuffer);
+        GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, dataFormat, GL_UNSIGNED_BYTE, data));
+        // Keep the minified levels in sync with the new pixels
+        GLCall(glGenerateMipmap(GL_TEXTURE_2D));
     }
+    resetUnpackRows();
+    GLCall(glBindTexture(GL_TEXTURE_2D, 0));
 }
 
 Texture::~Texture()
@@ -56,4 +156,4 @@ void Texture::Bind(unsigned int slot) const
 void Texture::Unbind() const
 {
     GLCall(glBindTexture(GL_TEXTURE_2D, 0));
-}
\ No newline at end of file
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <Debugger.h>
+#include <Image.h>
+#include <PixelFormat.h>
 
 #include <iostream>
 #include <string>
@@ -12,13 +14,27 @@ class Texture
         std::string m_Filepath;
         unsigned char* m_LocalBuffer;
         int m_Width, m_Height, m_Components;
+        PixelFormat m_Format;
     public:
         Texture(const std::string& filepath);
+
+        // Uploads raw pixels (top row first) without a decode step. Single channel data is
+        // stored as GL_R8 and swizzled to (r, r, r, 1) so shaders still sample grey RGBA,
+        // grey + alpha as GL_RG8 swizzled to (r, r, r, g).
+        // 'stride' is in bytes, 0 means tightly packed rows.
+        Texture(const unsigned char* data, int width, int height, PixelFormat format, int stride = 0);
+        Texture(const Image& image);
         ~Texture();
 
+        // Replaces a sub-rectangle of the texture with pixels in the texture's own format
+        void Update(const unsigned char* data, int x, int y, int width, int height, int stride = 0);
+
         void Bind(unsigned int slot = 0) const;
         void Unbind() const;
 
         inline int GetWidth() const { return m_Width; }
         inline int GetHeight() const { return m_Height; }
-};
\ No newline at end of file
+        inline PixelFormat GetFormat() const { return m_Format; }
+    private:
+        void Create(const unsigned char* data, int stride);
+};
@@ -0,0 +1,125 @@
+#include <ThreadPool.h>
+#include <Profiler.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+ThreadPool::ThreadPool(unsigned int threads)
+    : m_Stopping(false)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    // The thread calling ParallelFor() works too, so spawn one less
+    for (unsigned int i = 1; i < threads; i++)
+        m_Workers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stopping = true;
+    }
+    m_Condition.notify_all();
+    for (std::thread& worker : m_Workers)
+        worker.join();
+}
+
+void ThreadPool::Submit(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Jobs.push(std::move(job));
+    }
+    m_Condition.notify_one();
+}
+
+void ThreadPool::WorkerLoop()
+{
+    Profiler::SetThreadName("pool worker");
+    while (true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Condition.wait(lock, [this]() { return m_Stopping || !m_Jobs.empty(); });
+            if (m_Stopping && m_Jobs.empty())
+                return;
+            job = std::move(m_Jobs.front());
+            m_Jobs.pop();
+        }
+        PROFILE_SCOPE("pool job");
+        job();
+    }
+}
+
+void ThreadPool::ParallelFor(int count, const std::function<void(int)>& fn)
+{
+    if (count <= 0)
+        return;
+    if (count == 1 || m_Workers.empty())
+    {
+        for (int i = 0; i < count; i++)
+            fn(i);
+        return;
+    }
+
+    // Shared with helpers that may only get scheduled after everything is done
+    struct State
+    {
+        std::atomic<int> next{0};
+        std::atomic<int> done{0};
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    auto state = std::make_shared<State>();
+    const std::function<void(int)>* body = &fn;
+
+    auto work = [state, body, count]()
+    {
+        int i;
+        while ((i = state->next.fetch_add(1)) < count)
+        {
+            (*body)(i);
+            if (state->done.fetch_add(1) + 1 == count)
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->finished.notify_all();
+            }
+        }
+    };
+
+    int helpers = std::min((int)m_Workers.size(), count - 1);
+    for (int h = 0; h < helpers; h++)
+        Submit(work);
+    work();
+
+    // Only items already claimed by other threads can be outstanding here
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&]() { return state->done.load() == count; });
+}
+
+void ThreadPool::ParallelRanges(int count, int grain, const std::function<void(int, int)>& fn)
+{
+    if (count <= 0)
+        return;
+    grain = std::max(1, grain);
+    // A few chunks per thread keeps the load balanced
+    int chunks = std::min((count + grain - 1) / grain, (int)GetThreadCount() * 4);
+    chunks = std::max(1, chunks);
+    ParallelFor(chunks, [&](int c)
+    {
+        int begin = (int)((long long)count * c / chunks);
+        int end = (int)((long long)count * (c + 1) / chunks);
+        if (begin < end)
+            fn(begin, end);
+    });
+}
+
+ThreadPool& ThreadPool::Global()
+{
+    static ThreadPool pool;
+    return pool;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads fed from a single job queue
+class ThreadPool
+{
+    private:
+        std::vector<std::thread> m_Workers;
+        std::queue<std::function<void()>> m_Jobs;
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+        bool m_Stopping;
+    public:
+        // 0 threads means one per hardware thread
+        ThreadPool(unsigned int threads = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        void Submit(std::function<void()> job);
+
+        // Calls fn(i) for every i in [0, count) and returns once all calls are done.
+        // The calling thread takes part, so nested calls from inside a job can't deadlock.
+        void ParallelFor(int count, const std::function<void(int)>& fn);
+
+        // Splits [0, count) into contiguous ranges and calls fn(begin, end) for each
+        void ParallelRanges(int count, int grain, const std::function<void(int, int)>& fn);
+
+        inline unsigned int GetThreadCount() const { return (unsigned int)m_Workers.size() + 1; }
+
+        // Process wide pool sized to the machine
+        static ThreadPool& Global();
+    private:
+        void WorkerLoop();
+};
@@ -0,0 +1,83 @@
+#include <TileExecutor.h>
+
+#include <algorithm>
+#include <cstring>
+
+TileExecutor::TileExecutor(ThreadPool& pool, int tileWidth, int tileHeight)
+    : m_Pool(pool), m_TileWidth(std::max(1, tileWidth)), m_TileHeight(std::max(1, tileHeight))
+{
+}
+
+std::vector<Tile> TileExecutor::MakeTiles(int width, int height, int halo) const
+{
+    std::vector<Tile> tiles;
+    for (int y = 0; y < height; y += m_TileHeight)
+    {
+        for (int x = 0; x < width; x += m_TileWidth)
+        {
+            Tile tile;
+            tile.x = x;
+            tile.y = y;
+            tile.width = std::min(m_TileWidth, width - x);
+            tile.height = std::min(m_TileHeight, height - y);
+            tile.padX = std::max(0, x - halo);
+            tile.padY = std::max(0, y - halo);
+            tile.padWidth = std::min(width, x + tile.width + halo) - tile.padX;
+            tile.padHeight = std::min(height, y + tile.height + halo) - tile.padY;
+            tiles.push_back(tile);
+        }
+    }
+    return tiles;
+}
+
+void TileExecutor::ForEachTile(int width, int height, int halo, const std::function<void(const Tile&)>& fn)
+{
+    std::vector<Tile> tiles = MakeTiles(width, height, halo);
+    m_Pool.ParallelFor((int)tiles.size(), [&](int i) { fn(tiles[i]); });
+}
+
+void TileExecutor::Run(const unsigned char* src, unsigned char* dst, int width, int height, int halo,
+                       const std::function<void(unsigned char*, int, int)>& filter)
+{
+    Run(ConstImageView(src, width, height), ImageView(dst, width, height), halo, filter);
+}
+
+void TileExecutor::Run(ConstImageView src, ImageView dst, int halo,
+                       const std::function<void(unsigned char*, int, int)>& filter)
+{
+    ForEachTile(src.GetWidth(), src.GetHeight(), halo, [&](const Tile& tile)
+    {
+        unsigned char* buffer = Scratch((size_t)tile.padWidth * tile.padHeight);
+        CopyTileIn(src.GetData(), src.GetStride(), tile, buffer);
+        filter(buffer, tile.padWidth, tile.padHeight);
+        CopyTileOut(buffer, tile, dst.GetData(), dst.GetStride());
+    });
+}
+
+void TileExecutor::CopyTileIn(const unsigned char* src, int stride, const Tile& tile, unsigned char* buffer)
+{
+    for (int r = 0; r < tile.padHeight; r++)
+    {
+        std::memcpy(buffer + (size_t)r * tile.padWidth, src + (size_t)(tile.padY + r) * stride + tile.padX, tile.padWidth);
+    }
+}
+
+void TileExecutor::CopyTileOut(const unsigned char* buffer, const Tile& tile, unsigned char* dst, int stride)
+{
+    const int offsetX = tile.x - tile.padX;
+    const int offsetY = tile.y - tile.padY;
+    for (int r = 0; r < tile.height; r++)
+    {
+        std::memcpy(dst + (size_t)(tile.y + r) * stride + tile.x,
+                    buffer + (size_t)(offsetY + r) * tile.padWidth + offsetX, tile.width);
+    }
+}
+
+unsigned char* TileExecutor::Scratch(size_t size, int slot)
+{
+    thread_local std::vector<unsigned char> buffers[4];
+    std::vector<unsigned char>& buffer = buffers[slot & 3];
+    if (buffer.size() < size)
+        buffer.resize(size);
+    return buffer.data();
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <ImageView.h>
+#include <ThreadPool.h>
+
+#include <functional>
+#include <vector>
+
+struct Tile
+{
+    // Core region written by this tile (image coordinates)
+    int x, y, width, height;
+    // Core grown by the halo and clipped to the image, this is what the tile reads
+    int padX, padY, padWidth, padHeight;
+};
+
+// Splits a single channel image into tiles and runs them on a thread pool.
+// Each tile reads its core plus a halo of 'halo' pixels. A stage (or a chain of
+// stages) whose output depends on at most 'halo' pixels around each pixel gives
+// seamless results identical to running it on the whole frame, because every
+// pixel that a tile treats as a frame border is either a real border or lies in
+// the halo and is thrown away.
+class TileExecutor
+{
+    private:
+        ThreadPool& m_Pool;
+        int m_TileWidth, m_TileHeight;
+    public:
+        TileExecutor(ThreadPool& pool = ThreadPool::Global(), int tileWidth = 256, int tileHeight = 256);
+
+        std::vector<Tile> MakeTiles(int width, int height, int halo) const;
+
+        // Calls fn for every tile, in parallel
+        void ForEachTile(int width, int height, int halo, const std::function<void(const Tile&)>& fn);
+
+        // Copies each padded tile of 'src' into a per-thread buffer, runs 'filter(buffer, padWidth, padHeight)'
+        // on it in place with its usual full-frame semantics, and writes the tile core to 'dst'.
+        // 'dst' must not alias 'src' since neighbouring tiles still read their halo from it.
+        void Run(const unsigned char* src, unsigned char* dst, int width, int height, int halo,
+                 const std::function<void(unsigned char*, int, int)>& filter);
+
+        // Same between two single channel views of equal size (strides may differ)
+        void Run(ConstImageView src, ImageView dst, int halo,
+                 const std::function<void(unsigned char*, int, int)>& filter);
+
+        inline ThreadPool& GetPool() { return m_Pool; }
+
+        // Copy the padded region of a full frame into a tightly packed tile buffer and back.
+        // 'stride' is the frame's row pitch in bytes (its width when tightly packed).
+        static void CopyTileIn(const unsigned char* src, int stride, const Tile& tile, unsigned char* buffer);
+        static void CopyTileOut(const unsigned char* buffer, const Tile& tile, unsigned char* dst, int stride);
+
+        // Per-thread scratch buffer of at least 'size' bytes (slot picks one of a few independent buffers)
+        static unsigned char* Scratch(size_t size, int slot = 0);
+};